@@ -283,7 +283,10 @@ void CurveListPanel::update2ndColumnValues(double tracker_time)
 
 void CurveListPanel::refreshValues()
 {
-  auto default_foreground = _custom_view->palette().foreground();
+  if (is2ndColumnHidden())
+  {
+    return;
+  }
 
   auto FormattedNumber = [](double value) {
     QString num_text = QString::number(value, 'f', 3);
@@ -301,75 +304,77 @@ void CurveListPanel::refreshValues()
     return num_text + " ";
   };
 
-  auto GetValue = [&](const std::string& name) -> QString {
+  // The index of the last sample displayed is stored in the cell and used as
+  // hint by the next lookup. The text is updated only if the value changed.
+  auto DisplayValue = [&](QTreeWidgetItem* cell, const std::string& name) {
+    const int hint = cell->data(1, CustomRoles::ValueIndex).toInt();
     {
       auto it = _plot_data.numeric.find(name);
       if (it != _plot_data.numeric.end())
       {
         auto& plot_data = it->second;
-        auto val = plot_data.getYfromX(_tracker_time);
-        if (val)
+        int index = plot_data.getIndexFromX(_tracker_time, hint);
+        if (index >= 0)
         {
-          return FormattedNumber(val.value());
+          const double value = plot_data.at(index).y;
+          if (index != hint)
+          {
+            cell->setData(1, CustomRoles::ValueIndex, index);
+          }
+
+          const QVariant prev_value = cell->data(1, CustomRoles::DisplayedValue);
+          if (!prev_value.isValid() || prev_value.toDouble() != value)
+          {
+            cell->setData(1, CustomRoles::DisplayedValue, value);
+            cell->setText(1, FormattedNumber(value));
+          }
+          return;
         }
       }
     }
 
+    cell->setData(1, CustomRoles::DisplayedValue, QVariant());
     {
       auto it = _plot_data.strings.find(name);
       if (it != _plot_data.strings.end())
       {
         auto& plot_data = it->second;
-        auto val = plot_data.getYfromX(_tracker_time);
-        if (val)
+        int index = plot_data.getIndexFromX(_tracker_time, hint);
+        if (index >= 0)
         {
-          auto str_view = val.value();
-          char last_byte = str_view.data()[str_view.size() - 1];
-          if (last_byte == '\0')
-          {
-            return QString::fromLocal8Bit(str_view.data(), str_view.size() - 1);
-          }
-          else
+          cell->setData(1, CustomRoles::ValueIndex, index);
+          auto str_view = plot_data.at(index).y;
+          int size = str_view.size();
+          if (str_view.data()[size - 1] == '\0')
           {
-            return QString::fromLocal8Bit(str_view.data(), str_view.size());
+            size--;
           }
+          cell->setText(1, QString::fromLocal8Bit(str_view.data(), size));
+          return;
         }
       }
     }
-    return "-";
+    cell->setText(1, "-");
   };
 
   for (CurveTreeView* tree_view : { _tree_view, _custom_view })
   {
-    const int vertical_height = tree_view->visibleRegion().boundingRect().height();
+    // visit only the rows inside the viewport, instead of the entire tree
+    const int viewport_height = tree_view->viewport()->height();
 
-    auto DisplayValue = [&](QTreeWidgetItem* cell) {
+    for (QTreeWidgetItem* cell = tree_view->itemAt(0, 0); cell != nullptr;
+         cell = tree_view->itemBelow(cell))
+    {
+      if (tree_view->visualItemRect(cell).top() > viewport_height)
+      {
+        break;
+      }
       QString curve_name = cell->data(0, CustomRoles::Name).toString();
-
       if (!curve_name.isEmpty())
       {
-        auto rect = cell->treeWidget()->visualItemRect(cell);
-
-        if (rect.bottom() < 0 || cell->isHidden())
-        {
-          return;
-        }
-        if (rect.top() > vertical_height)
-        {
-          return;
-        }
-
-        if (!is2ndColumnHidden())
-        {
-          QString str_value = GetValue(curve_name.toStdString());
-          cell->setText(1, str_value);
-        }
+        DisplayValue(cell, curve_name.toStdString());
       }
-    };
-
-    tree_view->setViewResizeEnabled(false);
-    tree_view->treeVisitor(DisplayValue);
-    // tree_view->setViewResizeEnabled(true);
+    }
   }
 }
 
@@ -45,7 +45,11 @@ enum CustomRoles
 {
   Name = Qt::UserRole,
   IsGroupName = Qt::UserRole + 1,
-  ToolTip = Qt::UserRole + 2
+  ToolTip = Qt::UserRole + 2,
+  // index of the sample displayed in the column of the values
+  ValueIndex = Qt::UserRole + 3,
+  // value displayed in the column of the values, if numeric
+  DisplayedValue = Qt::UserRole + 4
 };
 
 class CurvesView
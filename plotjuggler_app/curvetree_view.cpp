@@ -12,6 +12,7 @@
 #include <QToolTip>
 #include <QKeySequence>
 #include <QClipboard>
+#include <numeric>
 
 class TreeWidgetItem : public QTreeWidgetItem
 {
@@ -47,6 +48,9 @@ CurveTreeView::CurveTreeView(CurveListPanel* parent)
   header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
   setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
 
+  QSettings settings;
+  _use_separator = settings.value("Preferences::use_separator", true).toBool();
+
   connect(this, &QTreeWidget::itemDoubleClicked, this,
           [this](QTreeWidgetItem* item, int column) {
             if (column == 0)
@@ -70,20 +74,26 @@ CurveTreeView::CurveTreeView(CurveListPanel* parent)
   });
 }
 
+void CurveTreeView::clear()
+{
+  QTreeWidget::clear();
+  _leaf_count = 0;
+  _hidden_count = 0;
+  _leaf_items.clear();
+  _child_items.clear();
+  _pending_parents.clear();
+  _filter_index_dirty = true;
+
+  // the list is rebuilt from scratch when the preferences change
+  QSettings settings;
+  _use_separator = settings.value("Preferences::use_separator", true).toBool();
+}
+
 void CurveTreeView::addItem(const QString& group_name, const QString& tree_name,
                             const QString& plot_ID)
 {
-  QSettings settings; /*
-                       * This Source Code Form is subject to the terms of the Mozilla
-                       * Public License, v. 2.0. If a copy of the MPL was not distributed
-                       * with this file, You can obtain one at
-                       * https://mozilla.org/MPL/2.0/.
-                       */
-
-  bool use_separator = settings.value("Preferences::use_separator", true).toBool();
-
   QStringList parts;
-  if (use_separator)
+  if (_use_separator)
   {
     parts = tree_name.split('/', QString::SplitBehavior::SkipEmptyParts);
   }
@@ -113,17 +123,9 @@ void CurveTreeView::addItem(const QString& group_name, const QString& tree_name,
     bool is_leaf = (i == parts.size() - 1);
     const auto& part = parts[i];
 
-    QTreeWidgetItem* matching_child = nullptr;
-
-    for (int c = 0; c < tree_parent->childCount(); c++)
-    {
-      QTreeWidgetItem* tree_child = tree_parent->child(c);
-      if (tree_child->text(0) == part)
-      {
-        matching_child = tree_child;
-        break;
-      }
-    }
+    // lookup in the hash table, instead of comparing all the children
+    QTreeWidgetItem* matching_child =
+        _child_items.value(ChildKey(tree_parent, part), nullptr);
 
     if (matching_child)
     {
@@ -134,6 +136,7 @@ void CurveTreeView::addItem(const QString& group_name, const QString& tree_name,
       QTreeWidgetItem* child_item = new TreeWidgetItem(tree_parent);
       child_item->setText(0, part);
       child_item->setText(1, is_leaf ? "-" : "");
+      _child_items.insert(ChildKey(tree_parent, part), child_item);
 
       bool isGroupCell = (i < group_parts.size());
 
@@ -161,6 +164,14 @@ void CurveTreeView::addItem(const QString& group_name, const QString& tree_name,
       {
         child_item->setFlags(current_flag | Qt::ItemIsSelectable);
         child_item->setData(0, Name, plot_ID);
+        _leaf_items.insert(plot_ID, child_item);
+        _filter_index_dirty = true;
+        _leaf_count++;
+        // the new leaf is visible: a filter might have hidden its ancestors
+        for (auto parent = child_item->parent(); parent; parent = parent->parent())
+        {
+          _pending_parents.insert(parent);
+        }
       }
       else
       {
@@ -168,7 +179,6 @@ void CurveTreeView::addItem(const QString& group_name, const QString& tree_name,
       }
     }
   }
-  _leaf_count++;
 }
 
 void CurveTreeView::refreshColumns()
@@ -208,47 +218,147 @@ void CurveTreeView::refreshFontSize()
   header()->setSectionResizeMode(1, QHeaderView::Stretch);
 }
 
-bool CurveTreeView::applyVisibilityFilter(const QString& search_string)
+static uint64_t TrigramKey(const QChar* str)
 {
-  bool updated = false;
-  _hidden_count = 0;
+  return (uint64_t(str[0].unicode()) << 32) | (uint64_t(str[1].unicode()) << 16) |
+         uint64_t(str[2].unicode());
+}
+
+void CurveTreeView::updateFilterIndex()
+{
+  if (!_filter_index_dirty)
+  {
+    return;
+  }
+  _filter_index_dirty = false;
+  _last_filter_valid = false;
+
+  _filter_leaves.clear();
+  _filter_names.clear();
+  _trigrams.clear();
+  _visible_leaves.clear();
+  _leaf_visible.clear();
 
-  QStringList spaced_items = search_string.split(' ', QString::SkipEmptyParts);
+  for (auto it = _leaf_items.begin(); it != _leaf_items.end(); it++)
+  {
+    const uint32_t id = _filter_leaves.size();
+    QTreeWidgetItem* item = it.value();
+    QString name = it.key().toLower();
 
-  auto hideFunc = [&](QTreeWidgetItem* item) {
-    QString name = item->data(0, Qt::UserRole).toString();
-    if (name.isEmpty())
+    for (int i = 0; i + 3 <= name.size(); i++)
+    {
+      auto& leaves = _trigrams[TrigramKey(name.constData() + i)];
+      if (leaves.empty() || leaves.back() != id)
+      {
+        leaves.push_back(id);
+      }
+    }
+    _filter_leaves.push_back(item);
+    _filter_names.push_back(std::move(name));
+    _leaf_visible.push_back(!item->isHidden());
+    if (!item->isHidden())
     {
-      return;  // not a leaf
+      _visible_leaves.push_back(id);
     }
-    bool toHide = false;
+  }
+}
+
+bool CurveTreeView::applyVisibilityFilter(const QString& search_string)
+{
+  updateFilterIndex();
 
-    if (search_string.isEmpty() == false)
+  const QString query = search_string.toLower();
+  const QStringList tokens = query.split(' ', QString::SkipEmptyParts);
+
+  // Select the leaves that need to be checked. If the query extends the
+  // previous one, the leaves that were hidden will stay hidden. Otherwise,
+  // use the least common trigram of the tokens.
+  std::vector<uint32_t> all_leaves;
+  static const std::vector<uint32_t> no_leaves;
+  const std::vector<uint32_t>* candidates = nullptr;
+
+  if (_last_filter_valid && query.startsWith(_last_filter))
+  {
+    candidates = &_visible_leaves;
+  }
+  else
+  {
+    for (const auto& token : tokens)
     {
-      for (const auto& spaced_item : spaced_items)
+      for (int i = 0; i + 3 <= token.size(); i++)
       {
-        if (name.contains(spaced_item, Qt::CaseInsensitive) == false)
+        auto it = _trigrams.find(TrigramKey(token.constData() + i));
+        const auto* leaves = (it == _trigrams.end()) ? &no_leaves : &it->second;
+        if (!candidates || leaves->size() < candidates->size())
         {
-          toHide = true;
-          break;
+          candidates = leaves;
         }
       }
     }
-    if (toHide)
+    if (!candidates)
     {
-      _hidden_count++;
+      all_leaves.resize(_filter_leaves.size());
+      std::iota(all_leaves.begin(), all_leaves.end(), 0);
+      candidates = &all_leaves;
     }
+  }
 
-    if (toHide != item->isHidden())
+  std::vector<uint32_t> visible_leaves;
+  std::vector<char> leaf_visible(_filter_leaves.size(), 0);
+  for (uint32_t id : *candidates)
+  {
+    bool match = true;
+    for (const auto& token : tokens)
     {
-      updated = true;
+      if (!_filter_names[id].contains(token))
+      {
+        match = false;
+        break;
+      }
+    }
+    if (match)
+    {
+      visible_leaves.push_back(id);
+      leaf_visible[id] = 1;
+    }
+  }
+
+  // change only the leaves that switched state, then their parents
+  bool updated = false;
+  QSet<QTreeWidgetItem*> changed_parents = std::move(_pending_parents);
+  _pending_parents.clear();
+  auto SetLeafHidden = [&](uint32_t id, bool hidden) {
+    QTreeWidgetItem* item = _filter_leaves[id];
+    item->setHidden(hidden);
+    updated = true;
+    if (item->parent())
+    {
+      changed_parents.insert(item->parent());
     }
+  };
 
-    item->setHidden(toHide);
+  setUpdatesEnabled(false);
 
-    // hide the parent if necessary
-    auto parent = item->parent();
-    while (parent)
+  for (uint32_t id : _visible_leaves)
+  {
+    if (!leaf_visible[id])
+    {
+      SetLeafHidden(id, true);
+    }
+  }
+  for (uint32_t id : visible_leaves)
+  {
+    if (!_leaf_visible[id])
+    {
+      SetLeafHidden(id, false);
+    }
+  }
+
+  // hide a parent if all its children are hidden
+  while (!changed_parents.empty())
+  {
+    QSet<QTreeWidgetItem*> next_parents;
+    for (QTreeWidgetItem* parent : changed_parents)
     {
       bool all_children_hidden = true;
       for (int c = 0; c < parent->childCount(); c++)
@@ -259,21 +369,25 @@ bool CurveTreeView::applyVisibilityFilter(const QString& search_string)
           break;
         }
       }
-      auto parent_hidden = parent->isHidden();
-      if (all_children_hidden != parent_hidden)
+      if (all_children_hidden != parent->isHidden())
       {
         parent->setHidden(all_children_hidden);
-        parent = parent->parent();
-      }
-      else
-      {
-        break;
+        if (parent->parent())
+        {
+          next_parents.insert(parent->parent());
+        }
       }
     }
-  };
+    changed_parents = std::move(next_parents);
+  }
+
+  setUpdatesEnabled(true);
 
-  treeVisitor(hideFunc);
-  //-------------
+  _visible_leaves = std::move(visible_leaves);
+  _leaf_visible = std::move(leaf_visible);
+  _hidden_count = int(_filter_leaves.size() - _visible_leaves.size());
+  _last_filter = query;
+  _last_filter_valid = true;
 
   return updated;
 }
@@ -311,32 +425,34 @@ bool CurveTreeView::eventFilter(QObject* object, QEvent* event)
 
 void CurveTreeView::removeCurve(const QString& to_be_deleted)
 {
-  auto removeFunc = [&](QTreeWidgetItem* item) {
-    QString curve_name = item->data(0, Qt::UserRole).toString();
-    if (curve_name == to_be_deleted)
-    {
-      _leaf_count--;
-      auto parent_item = item->parent();
-      if (!parent_item)
-      {
-        parent_item = invisibleRootItem();
-      }
-      parent_item->removeChild(item);
+  QTreeWidgetItem* item = _leaf_items.value(to_be_deleted, nullptr);
+  if (!item)
+  {
+    return;
+  }
+  _leaf_items.remove(to_be_deleted);
+  _filter_index_dirty = true;
+  _leaf_count--;
 
-      while (parent_item->childCount() == 0 && parent_item != invisibleRootItem())
-      {
-        auto prev_item = parent_item;
-        parent_item = parent_item->parent();
-        if (!parent_item)
-        {
-          parent_item = invisibleRootItem();
-        }
-        parent_item->removeChild(prev_item);
-      }
+  // remove the leaf and the parents left without children
+  while (item)
+  {
+    auto parent_item = item->parent();
+    if (item->childCount() > 0)
+    {
+      break;
     }
-  };
-
-  treeVisitor(removeFunc);
+    // the parent of the top level items is the invisible root, as in addItem()
+    const QTreeWidgetItem* key_parent = parent_item ? parent_item : invisibleRootItem();
+    _child_items.remove(ChildKey(key_parent, item->text(0)));
+    _pending_parents.remove(item);
+    delete item;
+    item = parent_item;
+  }
+  if (item)
+  {
+    _pending_parents.insert(item);
+  }
 }
 
 void CurveTreeView::hideValuesColumn(bool hide)
@@ -9,19 +9,18 @@
 
 #include "curvelist_view.h"
 #include <QTreeWidget>
+#include <QHash>
+#include <QPair>
+#include <QSet>
 #include <functional>
+#include <unordered_map>
 
 class CurveTreeView : public QTreeWidget, public CurvesView
 {
 public:
   CurveTreeView(CurveListPanel* parent);
 
-  void clear() override
-  {
-    QTreeWidget::clear();
-    _leaf_count = 0;
-    _hidden_count = 0;
-  }
+  void clear() override;
 
   void addItem(const QString& prefix, const QString& tree_name,
                const QString& plot_ID) override;
@@ -56,8 +55,36 @@ public:
 private:
   void expandChildren(bool expanded, QTreeWidgetItem* item);
 
+  // rebuild the index used by applyVisibilityFilter(), if needed
+  void updateFilterIndex();
+
   int _hidden_count = 0;
   int _leaf_count = 0;
+  bool _use_separator = true;
+
+  // leaves by plot_ID and all the items by parent and text, to avoid visiting
+  // the tree. The text of an item may contain '/' when the separator is disabled,
+  // therefore the key can't be the joined path.
+  using ChildKey = QPair<const QTreeWidgetItem*, QString>;
+  QHash<QString, QTreeWidgetItem*> _leaf_items;
+  QHash<ChildKey, QTreeWidgetItem*> _child_items;
+
+  // Substring search index: lowercase name of each leaf and, for each
+  // trigram, the sorted list of leaves that contain it.
+  bool _filter_index_dirty = true;
+  std::vector<QTreeWidgetItem*> _filter_leaves;
+  std::vector<QString> _filter_names;
+  std::unordered_map<uint64_t, std::vector<uint32_t>> _trigrams;
+
+  // result of the last filter
+  bool _last_filter_valid = false;
+  QString _last_filter;
+  std::vector<uint32_t> _visible_leaves;
+  std::vector<char> _leaf_visible;
+
+  // parents whose visibility must be checked again by the next filter, because
+  // leaves were added below them or removed
+  QSet<QTreeWidgetItem*> _pending_parents;
 };
 
 #endif  // CURVETREE_VIEW_H
@@ -0,0 +1,199 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "history_archive.h"
+#include <algorithm>
+#include <cstring>
+#include <QDir>
+#include "lz4.h"
+#include "PlotJuggler/util/gorilla_codec.hpp"
+
+using namespace PJ;
+
+HistoryArchive::HistoryArchive()
+  : _file(QDir::tempPath() + "/plotjuggler_history_XXXXXX.bin")
+{
+  _valid = _file.open();
+}
+
+void HistoryArchive::archiveExpired(const std::string& name, const PlotData& series,
+                                    double max_range)
+{
+  // same condition used by TimeseriesBase::trimRange()
+  if (!_valid || max_range >= std::numeric_limits<double>::max() || series.size() <= 2)
+  {
+    return;
+  }
+  const double back_x = series.back().x;
+  if ((back_x - series.front().x) <= max_range)
+  {
+    return;
+  }
+  auto first_kept = std::partition_point(
+      series.begin(), series.end() - 2,
+      [&](const PlotData::Point& p) { return (back_x - p.x) > max_range; });
+
+  SeriesArchive& archive = _series[name];
+  for (auto it = series.begin(); it != first_kept; it++)
+  {
+    archive.pending.push_back(*it);
+    if (archive.pending.size() >= CHUNK_SIZE)
+    {
+      writeChunk(archive);
+    }
+  }
+}
+
+void HistoryArchive::flush()
+{
+  for (auto& [name, archive] : _series)
+  {
+    writeChunk(archive);
+  }
+  _file.flush();
+}
+
+void HistoryArchive::writeChunk(SeriesArchive& archive)
+{
+  const auto& points = archive.pending;
+  if (points.empty())
+  {
+    return;
+  }
+  // Gorilla encoding takes advantage of regular timestamps and slowly changing
+  // values; LZ4 removes the redundancy that is left.
+  GorillaEncoder encoder;
+  for (const auto& p : points)
+  {
+    encoder.push(p.x, p.y);
+  }
+  _words = encoder.takeWords();
+  const int raw_size = int(_words.size() * sizeof(uint64_t));
+  _buffer.resize(size_t(LZ4_compressBound(raw_size)));
+  const int compressed_size =
+      LZ4_compress_default(reinterpret_cast<const char*>(_words.data()), _buffer.data(),
+                           raw_size, int(_buffer.size()));
+
+  Chunk chunk;
+  chunk.offset = _file.size();
+  chunk.compressed_size = compressed_size;
+  chunk.count = int(points.size());
+  chunk.encoded_words = int(_words.size());
+  chunk.t_min = points.front().x;
+  chunk.t_max = points.back().x;
+
+  if (compressed_size > 0 && _file.seek(chunk.offset) &&
+      _file.write(_buffer.data(), compressed_size) == compressed_size)
+  {
+    archive.chunks.push_back(chunk);
+  }
+  archive.pending.clear();
+}
+
+bool HistoryArchive::readChunk(const Chunk& chunk, std::vector<PlotData::Point>& points)
+{
+  _buffer.resize(size_t(chunk.compressed_size));
+  if (!_file.seek(chunk.offset) ||
+      _file.read(_buffer.data(), chunk.compressed_size) != chunk.compressed_size)
+  {
+    return false;
+  }
+  _words.resize(size_t(chunk.encoded_words));
+  const int raw_size = int(_words.size() * sizeof(uint64_t));
+  if (LZ4_decompress_safe(_buffer.data(), reinterpret_cast<char*>(_words.data()),
+                          chunk.compressed_size, raw_size) != raw_size)
+  {
+    return false;
+  }
+  GorillaDecoder decoder(_words.data(), size_t(chunk.count));
+  PlotData::Point p;
+  while (decoder.next(p.x, p.y))
+  {
+    points.push_back(p);
+  }
+  return true;
+}
+
+bool HistoryArchive::page(const std::string& name, double t_min, double t_max,
+                          PlotData& series)
+{
+  auto it = _series.find(name);
+  if (it == _series.end())
+  {
+    return false;
+  }
+  SeriesArchive& archive = it->second;
+  writeChunk(archive);
+  const auto& chunks = archive.chunks;
+
+  // chunks are sorted by time and don't overlap
+  auto ends_before = [t_min](const Chunk& c) { return c.t_max < t_min; };
+  auto starts_before = [t_max](const Chunk& c) { return c.t_min <= t_max; };
+  size_t first = size_t(std::distance(
+      chunks.begin(), std::partition_point(chunks.begin(), chunks.end(), ends_before)));
+  size_t last = size_t(std::distance(
+      chunks.begin(), std::partition_point(chunks.begin(), chunks.end(), starts_before)));
+  if (first < last)
+  {
+    // the neighbours, to draw the curve up to the borders of the view
+    first = (first > 0) ? first - 1 : 0;
+    last = std::min(chunks.size(), last + 1);
+  }
+  else
+  {
+    first = last = 0;
+  }
+  if (first == archive.paged_first && last == archive.paged_last)
+  {
+    return false;
+  }
+
+  if (archive.paged_first == archive.paged_last)
+  {
+    archive.live_front =
+        series.size() == 0 ? std::numeric_limits<double>::max() : series.front().x;
+  }
+
+  std::vector<PlotData::Point> points;
+  for (size_t i = first; i < last; i++)
+  {
+    if (!readChunk(chunks[i], points))
+    {
+      return false;
+    }
+  }
+
+  // the archived points are older than the ones that were never archived
+  const size_t evicted = series.lowerBound(archive.live_front);
+  PlotData merged(series.plotName(), series.group());
+  merged.pushBack(points.begin(), points.end());
+  merged.pushBack(std::next(series.begin(), long(evicted)), series.end());
+  series.clonePoints(merged);
+
+  archive.paged_first = first;
+  archive.paged_last = last;
+  return true;
+}
+
+std::vector<std::string> HistoryArchive::seriesNames() const
+{
+  std::vector<std::string> names;
+  names.reserve(_series.size());
+  for (const auto& [name, archive] : _series)
+  {
+    names.push_back(name);
+  }
+  return names;
+}
+
+void HistoryArchive::clear()
+{
+  _series.clear();
+  if (_valid)
+  {
+    _file.resize(0);
+  }
+}
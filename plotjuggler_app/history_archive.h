@@ -0,0 +1,108 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef HISTORY_ARCHIVE_H
+#define HISTORY_ARCHIVE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <QTemporaryFile>
+#include "PlotJuggler/plotdata.h"
+
+/**
+ * @brief Disk storage for the streamed data that is older than the buffer.
+ *
+ * The points removed by the retention of the streaming buffer are collected in
+ * chunks, compressed with GorillaEncoder and LZ4, and appended to a temporary file
+ * that is deleted
+ * when the archive is destroyed. Only the index of the chunks stays in memory.
+ *
+ * Once the streaming is stopped and the series are not trimmed anymore, page()
+ * loads back only the chunks needed by the visible time range. They are placed
+ * in front of the data that was never archived and replaced when the view moves,
+ * so only a window of the history is in memory.
+ */
+class HistoryArchive
+{
+public:
+  HistoryArchive();
+
+  /// False if the temporary file could not be created.
+  bool isValid() const
+  {
+    return _valid;
+  }
+
+  /**
+   * @brief Save the points that series.setMaximumRangeX(max_range) is about to remove.
+   * Must be called right before it.
+   */
+  void archiveExpired(const std::string& name, const PJ::PlotData& series,
+                      double max_range);
+
+  /// Write to disk the points that are still buffered.
+  void flush();
+
+  /**
+   * @brief Keep in the series the archived chunks that overlap the range
+   * [t_min, t_max], plus one chunk on each side, removing the ones that were
+   * loaded before and are not needed anymore.
+   *
+   * @return true if the points of the series changed.
+   */
+  bool page(const std::string& name, double t_min, double t_max, PJ::PlotData& series);
+
+  /// Names of the series with archived data.
+  std::vector<std::string> seriesNames() const;
+
+  /// Size of the temporary file, in bytes.
+  qint64 diskUsage() const
+  {
+    return _file.size();
+  }
+
+  void clear();
+
+private:
+  // number of points in a chunk
+  static constexpr size_t CHUNK_SIZE = 8192;
+
+  struct Chunk
+  {
+    qint64 offset;
+    int compressed_size;
+    int count;
+    // size of the Gorilla encoded data, in 64 bits words
+    int encoded_words;
+    double t_min;
+    double t_max;
+  };
+
+  struct SeriesArchive
+  {
+    std::vector<PJ::PlotData::Point> pending;
+    std::vector<Chunk> chunks;
+    // chunks in the range [paged_first, paged_last) are in the series
+    size_t paged_first = 0;
+    size_t paged_last = 0;
+    // time of the first point that was never archived. The paged points are
+    // the ones before it.
+    double live_front = 0;
+  };
+
+  void writeChunk(SeriesArchive& archive);
+
+  bool readChunk(const Chunk& chunk, std::vector<PJ::PlotData::Point>& points);
+
+  QTemporaryFile _file;
+  bool _valid = false;
+  std::unordered_map<std::string, SeriesArchive> _series;
+  std::vector<uint64_t> _words;
+  std::vector<char> _buffer;
+};
+
+#endif  // HISTORY_ARCHIVE_H
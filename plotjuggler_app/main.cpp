@@ -24,6 +24,7 @@
 #include "transforms/scale_transform.h"
 #include "transforms/moving_average_filter.h"
 #include "transforms/moving_rms.h"
+#include "transforms/moving_window_statistics.h"
 #include "transforms/outlier_removal.h"
 #include "transforms/integral_transform.h"
 #include "transforms/absolute_transform.h"
@@ -214,6 +215,9 @@ int main(int argc, char* argv[])
   TransformFactory::registerTransform<ScaleTransform>();
   TransformFactory::registerTransform<MovingAverageFilter>();
   TransformFactory::registerTransform<MovingRMS>();
+  TransformFactory::registerTransform<MovingMinimum>();
+  TransformFactory::registerTransform<MovingMaximum>();
+  TransformFactory::registerTransform<MovingStandardDeviation>();
   TransformFactory::registerTransform<OutlierRemovalFilter>();
   TransformFactory::registerTransform<IntegralTransform>();
   TransformFactory::registerTransform<AbsoluteTransform>();
@@ -7,6 +7,8 @@
 #include <functional>
 #include <stdio.h>
 #include <numeric>
+#include <algorithm>
+#include <unordered_set>
 
 #include <QApplication>
 #include <QActionGroup>
@@ -44,6 +46,7 @@
 #include "PlotJuggler/plotdata.h"
 #include "qwt_plot_canvas.h"
 #include "transforms/function_editor.h"
+#include "transforms/transform_scheduler.h"
 #include "transforms/lua_custom_function.h"
 #include "utils.h"
 #include "stylesheet.h"
@@ -248,13 +251,17 @@ MainWindow::MainWindow(const QCommandLineParser& commandline_parser, QWidget* pa
 
   //------------------------------------
 
-  _undo_timer.start();
+  _undo_timer.setSingleShot(true);
+  _undo_timer.setInterval(100);
+  connect(&_undo_timer, &QTimer::timeout, this, &MainWindow::saveUndoState);
 
   // save initial state
-  onUndoableChange();
+  _undo_history.reset(xmlSaveState());
 
-  _replot_timer = new QTimer(this);
-  connect(_replot_timer, &QTimer::timeout, this,
+  _replot_scheduler = new ReplotScheduler(
+      [this](std::function<void(PlotWidget*)> op) { forEachWidget(op); },
+      [this](const std::vector<PlotWidget*>& plots) { updatePlots(plots); }, this);
+  connect(_replot_scheduler, &ReplotScheduler::updateRequested, this,
           [this]() { updateDataAndReplot(false); });
 
   _publish_timer = new QTimer(this);
@@ -403,54 +410,43 @@ void MainWindow::onUndoableChange()
   if (_disable_undo_logging)
     return;
 
-  int elapsed_ms = _undo_timer.restart();
-
-  // overwrite the previous
-  if (elapsed_ms < 100)
-  {
-    if (_undo_states.empty() == false)
-      _undo_states.pop_back();
-  }
+  // Wait until the changes stop (dragging, zooming with the wheel),
+  // instead of serializing the entire layout at each step.
+  _undo_timer.start();
+}
 
-  while (_undo_states.size() >= 100)
-    _undo_states.pop_front();
-  _undo_states.push_back(xmlSaveState());
-  _redo_states.clear();
-  // qDebug() << "undo " << _undo_states.size();
+void MainWindow::saveUndoState()
+{
+  _undo_timer.stop();
+  _undo_history.push(xmlSaveState());
 }
 
 void MainWindow::onRedoInvoked()
 {
+  // a pending change would be lost otherwise
+  if (_undo_timer.isActive())
+  {
+    saveUndoState();
+  }
   _disable_undo_logging = true;
-  if (_redo_states.size() > 0)
+  if (auto state_document = _undo_history.redo())
   {
-    QDomDocument state_document = _redo_states.back();
-    while (_undo_states.size() >= 100)
-      _undo_states.pop_front();
-    _undo_states.push_back(state_document);
-    _redo_states.pop_back();
-
-    xmlLoadState(state_document);
+    xmlLoadState(*state_document);
   }
-  // qDebug() << "undo " << _undo_states.size();
   _disable_undo_logging = false;
 }
 
 void MainWindow::onUndoInvoked()
 {
+  if (_undo_timer.isActive())
+  {
+    saveUndoState();
+  }
   _disable_undo_logging = true;
-  if (_undo_states.size() > 1)
+  if (auto state_document = _undo_history.undo())
   {
-    QDomDocument state_document = _undo_states.back();
-    while (_redo_states.size() >= 100)
-      _redo_states.pop_front();
-    _redo_states.push_back(state_document);
-    _undo_states.pop_back();
-    state_document = _undo_states.back();
-
-    xmlLoadState(state_document);
+    xmlLoadState(*state_document);
   }
-  // qDebug() << "undo " << _undo_states.size();
   _disable_undo_logging = false;
 }
 
@@ -487,13 +483,13 @@ void MainWindow::onTrackerTimeUpdated(double absolute_time, bool do_replot)
 
   updateReactivePlots();
 
-  forEachWidget([&](PlotWidget* plot) {
-    plot->setTrackerPosition(_tracker_time);
-    if (do_replot)
-    {
-      plot->replot();
-    }
-  });
+  forEachWidget([&](PlotWidget* plot) { plot->setTrackerPosition(_tracker_time); });
+
+  if (do_replot)
+  {
+    _replot_scheduler->invalidateAll(ReplotScheduler::Change::REPLOT);
+    _replot_scheduler->flush();
+  }
 }
 
 void MainWindow::initializeActions()
@@ -787,10 +783,9 @@ QStringList MainWindow::initializePlugins(QString directory_name)
                 &MainWindow::on_deleteSerieFromGroup);
 
         connect(streamer, &DataStreamer::dataReceived, this, [this]() {
-          if (isStreamingActive() && !_replot_timer->isActive())
+          if (isStreamingActive())
           {
-            _replot_timer->setSingleShot(true);
-            _replot_timer->start(40);
+            _replot_scheduler->requestUpdate();
           }
         });
 
@@ -931,10 +926,13 @@ void MainWindow::onPlotAdded(PlotWidget* plot)
   connect(this, &MainWindow::dataSourceRemoved, plot, &PlotWidget::onDataSourceRemoved);
 
   connect(plot, &PlotWidget::curveListChanged, this, [this]() {
+    _plotted_series_changed = true;
     updateTimeOffset();
     updateTimeSlider();
   });
 
+  connect(plot, &QObject::destroyed, this, [this]() { _plotted_series_changed = true; });
+
   connect(&_time_offset, SIGNAL(valueChanged(double)), plot,
           SLOT(on_changeTimeOffset(double)));
 
@@ -981,6 +979,12 @@ void MainWindow::onPlotZoomChanged(PlotWidget* modified_plot, QRectF new_range)
     this->forEachWidget(visitor);
   }
 
+  if (_history_archive && !_active_streamer_plugin && !modified_plot->isXYPlot())
+  {
+    pageArchivedHistory(new_range.left() + _time_offset.get(),
+                        new_range.right() + _time_offset.get());
+  }
+
   onUndoableChange();
 }
 
@@ -1278,8 +1282,9 @@ void MainWindow::deleteAllData()
   _transform_functions.clear();
   _curvelist_widget->clear();
   _loaded_datafiles.clear();
-  _undo_states.clear();
-  _redo_states.clear();
+  _history_archive.reset();
+  _undo_timer.stop();
+  _undo_history.clear();
 
   bool stopped = false;
 
@@ -1327,15 +1332,14 @@ void MainWindow::importPlotDataMap(PlotDataMapRef& new_data, bool remove_old)
     ClearOldSeries(_mapped_plot_data.strings, new_data.strings);
   }
 
-  auto [added_curves, curve_updated, data_pushed] =
-      MoveData(new_data, _mapped_plot_data, remove_old);
+  auto move_ret = MoveData(new_data, _mapped_plot_data, remove_old);
 
-  for (const auto& added_curve : added_curves)
+  for (const auto& added_curve : move_ret.added_curves)
   {
     _curvelist_widget->addCurve(added_curve);
   }
 
-  if (curve_updated)
+  if (move_ret.curves_updated)
   {
     _curvelist_widget->refreshColumns();
   }
@@ -1660,6 +1664,11 @@ void MainWindow::stopStreamingPlugin()
 
   // reset max range.
   _mapped_plot_data.setMaximumRangeX(std::numeric_limits<double>::max());
+
+  if (_history_archive)
+  {
+    _history_archive->flush();
+  }
 }
 
 void MainWindow::startStreamingPlugin(QString streamer_name)
@@ -1706,6 +1715,17 @@ void MainWindow::startStreamingPlugin(QString streamer_name)
   // The attemp to start the plugin may have succeded or failed
   if (started)
   {
+    _history_archive.reset();
+    if (QSettings().value("Preferences::spill_history", false).toBool())
+    {
+      _history_archive = std::make_unique<HistoryArchive>();
+      if (!_history_archive->isValid())
+      {
+        qDebug() << "The temporary file to save the streaming history can't be created";
+        _history_archive.reset();
+      }
+    }
+
     {
       std::lock_guard<std::mutex> lock(_active_streamer_plugin->mutex());
       importPlotDataMap(_active_streamer_plugin->dataMap(), false);
@@ -1779,6 +1799,75 @@ void MainWindow::updateDerivedSeries()
   }
 }
 
+void MainWindow::pageArchivedHistory(double t_min, double t_max)
+{
+  std::unordered_set<const PlotData*> changed;
+  for (const auto& name : _history_archive->seriesNames())
+  {
+    auto it = _mapped_plot_data.numeric.find(name);
+    if (it != _mapped_plot_data.numeric.end() &&
+        _history_archive->page(name, t_min, t_max, it->second))
+    {
+      changed.insert(&it->second);
+    }
+  }
+  if (changed.empty())
+  {
+    return;
+  }
+
+  // compute again the custom functions that depend, directly or not, on the
+  // paged series. Sorted by order(), a function comes after its sources.
+  std::vector<TransformFunction*> functions;
+  for (auto& [id, function] : _transform_functions)
+  {
+    if (dynamic_cast<ReactiveLuaFunction*>(function.get()) == nullptr)
+    {
+      functions.push_back(function.get());
+    }
+  }
+  std::sort(functions.begin(), functions.end(),
+            [](const TransformFunction* a, const TransformFunction* b) {
+              return a->order() < b->order();
+            });
+
+  std::vector<TransformFunction*> transforms;
+  for (TransformFunction* function : functions)
+  {
+    if (auto custom = dynamic_cast<CustomFunction*>(function))
+    {
+      try
+      {
+        custom->updateDataSources();
+      }
+      catch (std::runtime_error&)
+      {
+        continue;
+      }
+    }
+    const auto& sources = function->dataSources();
+    if (std::none_of(sources.begin(), sources.end(),
+                     [&](const PlotData* src) { return changed.count(src) > 0; }))
+    {
+      continue;
+    }
+    for (PlotData* dst : function->dataDestinations())
+    {
+      dst->clear();
+      changed.insert(dst);
+    }
+    function->reset();
+    transforms.push_back(function);
+  }
+  TransformScheduler::calculate(transforms);
+
+  forEachWidget([](PlotWidget* plot) {
+    plot->updateCurves(true);
+    plot->replot();
+  });
+  updateTimeSlider();
+}
+
 void MainWindow::updateReactivePlots()
 {
   std::unordered_set<std::string> updated_curves;
@@ -1804,15 +1893,11 @@ void MainWindow::updateReactivePlots()
     _curvelist_widget->refreshColumns();
   }
 
-  forEachWidget([&](PlotWidget* plot) {
-    for (auto& curve : plot->curveList())
-    {
-      if (updated_curves.count(curve.src_name) != 0)
-      {
-        plot->replot();
-      }
-    }
-  });
+  // replotted by the caller, with the next flush of the scheduler
+  for (const auto& name : updated_curves)
+  {
+    _replot_scheduler->seriesChanged(name, ReplotScheduler::Change::REPLOT);
+  }
 }
 
 void MainWindow::dragEnterEvent(QDragEnterEvent* event)
@@ -1940,48 +2025,34 @@ QDomElement MainWindow::savePluginState(QDomDocument& doc)
 
 std::tuple<double, double, int> MainWindow::calculateVisibleRangeX()
 {
-  // find min max time
-  double min_time = std::numeric_limits<double>::max();
-  double max_time = std::numeric_limits<double>::lowest();
-  int max_steps = 0;
-
-  forEachWidget([&](const PlotWidget* widget) {
-    for (auto& it : widget->curveList())
-    {
-      const auto& curve_name = it.src_name;
-
-      auto plot_it = _mapped_plot_data.numeric.find(curve_name);
-      if (plot_it == _mapped_plot_data.numeric.end())
-      {
-        continue;  // FIXME?
-      }
-      const auto& data = plot_it->second;
-      if (data.size() >= 1)
+  if (_plotted_series_changed)
+  {
+    std::unordered_set<std::string> plotted;
+    forEachWidget([&](const PlotWidget* widget) {
+      for (auto& it : widget->curveList())
       {
-        const double t0 = data.front().x;
-        const double t1 = data.back().x;
-        min_time = std::min(min_time, t0);
-        max_time = std::max(max_time, t1);
-        max_steps = std::max(max_steps, (int)data.size());
+        plotted.insert(it.src_name);
       }
-    }
-  });
+    });
+    _mapped_plot_data.setTimeBoundsSelection(std::move(plotted));
+    _plotted_series_changed = false;
+  }
 
-  // needed if all the plots are empty
-  if (max_steps == 0 || max_time < min_time)
+  // the range of the plotted series; needed if all the plots are empty
+  const TimeBounds* bounds = &_mapped_plot_data.selectionTimeBounds();
+  if (bounds->empty())
   {
-    for (const auto& it : _mapped_plot_data.numeric)
-    {
-      const PlotData& data = it.second;
-      if (data.size() >= 1)
-      {
-        const double t0 = data.front().x;
-        const double t1 = data.back().x;
-        min_time = std::min(min_time, t0);
-        max_time = std::max(max_time, t1);
-        max_steps = std::max(max_steps, (int)data.size());
-      }
-    }
+    bounds = &_mapped_plot_data.timeBounds();
+  }
+
+  double min_time = std::numeric_limits<double>::max();
+  double max_time = std::numeric_limits<double>::lowest();
+  int max_steps = 0;
+  if (!bounds->empty())
+  {
+    min_time = bounds->range().min;
+    max_time = bounds->range().max;
+    max_steps = int(bounds->maxSize());
   }
 
   // last opportunity. Everything else failed
@@ -2238,8 +2309,8 @@ bool MainWindow::loadLayoutFromFile(QString filename)
 
   linkedZoomOut();
 
-  _undo_states.clear();
-  _undo_states.push_back(domDocument);
+  _undo_timer.stop();
+  _undo_history.reset(domDocument);
   return true;
 }
 
@@ -2254,44 +2325,7 @@ void MainWindow::linkedZoomOut()
       {
         if (PlotDocker* matrix = dynamic_cast<PlotDocker*>(tabs->widget(t)))
         {
-          bool first = true;
-          Range range;
-          // find the ideal zoom
-          for (int index = 0; index < matrix->plotCount(); index++)
-          {
-            PlotWidget* plot = matrix->plotAt(index);
-            if (plot->isEmpty())
-            {
-              continue;
-            }
-
-            auto rect = plot->maxZoomRect();
-            if (first)
-            {
-              range.min = rect.left();
-              range.max = rect.right();
-              first = false;
-            }
-            else
-            {
-              range.min = std::min(rect.left(), range.min);
-              range.max = std::max(rect.right(), range.max);
-            }
-          }
-
-          for (int index = 0; index < matrix->plotCount() && !first; index++)
-          {
-            PlotWidget* plot = matrix->plotAt(index);
-            if (plot->isEmpty())
-            {
-              continue;
-            }
-            QRectF bound_act = plot->maxZoomRect();
-            bound_act.setLeft(range.min);
-            bound_act.setRight(range.max);
-            plot->setZoomRectangle(bound_act, false);
-            plot->replot();
-          }
+          linkedZoomOut(matrix);
         }
       }
     }
@@ -2302,6 +2336,80 @@ void MainWindow::linkedZoomOut()
   }
 }
 
+void MainWindow::linkedZoomOut(PlotDocker* matrix)
+{
+  bool first = true;
+  Range range;
+  // find the ideal zoom
+  for (int index = 0; index < matrix->plotCount(); index++)
+  {
+    PlotWidget* plot = matrix->plotAt(index);
+    if (plot->isEmpty())
+    {
+      continue;
+    }
+
+    auto rect = plot->maxZoomRect();
+    if (first)
+    {
+      range.min = rect.left();
+      range.max = rect.right();
+      first = false;
+    }
+    else
+    {
+      range.min = std::min(rect.left(), range.min);
+      range.max = std::max(rect.right(), range.max);
+    }
+  }
+
+  for (int index = 0; index < matrix->plotCount() && !first; index++)
+  {
+    PlotWidget* plot = matrix->plotAt(index);
+    if (plot->isEmpty())
+    {
+      continue;
+    }
+    QRectF bound_act = plot->maxZoomRect();
+    bound_act.setLeft(range.min);
+    bound_act.setRight(range.max);
+    plot->setZoomRectangle(bound_act, false);
+    plot->replot();
+  }
+}
+
+void MainWindow::updatePlots(const std::vector<PlotWidget*>& plots)
+{
+  for (PlotWidget* plot : plots)
+  {
+    plot->updateCurves(false);
+  }
+
+  if (ui->pushButtonLink->isChecked())
+  {
+    // the linked range depends on all the plots of the same tab
+    std::unordered_set<PlotWidget*> updated(plots.begin(), plots.end());
+    std::set<PlotDocker*> matrices;
+    forEachWidget([&](PlotWidget* plot, PlotDocker* matrix, int) {
+      if (updated.count(plot) != 0)
+      {
+        matrices.insert(matrix);
+      }
+    });
+    for (PlotDocker* matrix : matrices)
+    {
+      linkedZoomOut(matrix);
+    }
+  }
+  else
+  {
+    for (PlotWidget* plot : plots)
+    {
+      plot->zoomOut(false);
+    }
+  }
+}
+
 void MainWindow::on_tabbedAreaDestroyed(QObject* object)
 {
   this->setFocus();
@@ -2366,7 +2474,7 @@ void MainWindow::updateTimeOffset()
 
 void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
 {
-  _replot_timer->stop();
+  _replot_scheduler->stop();
 
   MoveDataRet move_ret;
 
@@ -2381,42 +2489,59 @@ void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
     {
       _curvelist_widget->addCurve(str);
     }
+    for (const auto& name : move_ret.updated_curves)
+    {
+      _replot_scheduler->seriesChanged(name, ReplotScheduler::Change::UPDATE);
+    }
 
     if (move_ret.curves_updated)
     {
       _curvelist_widget->refreshColumns();
     }
 
-    _mapped_plot_data.setMaximumRangeX(ui->streamingSpinBox->value());
+    const double max_range = ui->streamingSpinBox->value();
+    if (_history_archive)
+    {
+      for (const auto& [name, series] : _mapped_plot_data.numeric)
+      {
+        _history_archive->archiveExpired(name, series, max_range);
+      }
+    }
+    _mapped_plot_data.setMaximumRangeX(max_range);
   }
 
   const bool is_streaming_active = isStreamingActive();
 
   //--------------------------------
+  // Update the reactive plots
+  updateReactivePlots();
+
+  // update all transforms, but not the ReactiveLuaFunction
   std::vector<TransformFunction*> transforms;
   transforms.reserve(_transform_functions.size());
   for (auto& [id, function] : _transform_functions)
   {
-    transforms.push_back(function.get());
+    if (dynamic_cast<ReactiveLuaFunction*>(function.get()) == nullptr)
+    {
+      transforms.push_back(function.get());
+    }
   }
-  std::sort(
-      transforms.begin(), transforms.end(),
-      [](TransformFunction* a, TransformFunction* b) { return a->order() < b->order(); });
-
-  // Update the reactive plots
-  updateReactivePlots();
+  TransformScheduler::calculate(transforms);
 
-  // update all transforms, but not the ReactiveLuaFunction
-  for (auto& function : transforms)
+  // without a streamer, the data was loaded or modified by other means
+  if (replot_hidden_tabs || !_active_streamer_plugin)
+  {
+    _replot_scheduler->invalidateAll(ReplotScheduler::Change::UPDATE);
+  }
+  else if (move_ret.data_pushed)
   {
-    if (dynamic_cast<ReactiveLuaFunction*>(function) == nullptr)
+    // the custom series have new points too
+    for (const auto& [id, function] : _transform_functions)
     {
-      function->calculate();
+      _replot_scheduler->seriesChanged(id, ReplotScheduler::Change::UPDATE);
     }
   }
 
-  forEachWidget([](PlotWidget* plot) { plot->updateCurves(false); });
-
   //--------------------------------
   // trigger again the execution of this callback if steaming == true
   if (is_streaming_active)
@@ -2432,7 +2557,8 @@ void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
     updateTimeSlider();
   }
   //--------------------------------
-  linkedZoomOut();
+  // only the visible plots are updated now, the others once they are shown
+  _replot_scheduler->flush();
 }
 
 void MainWindow::on_streamingSpinBox_valueChanged(int value)
@@ -2444,11 +2570,21 @@ void MainWindow::on_streamingSpinBox_valueChanged(int value)
     return;
   }
 
+  if (_history_archive)
+  {
+    for (const auto& [name, series] : _mapped_plot_data.numeric)
+    {
+      _history_archive->archiveExpired(name, series, real_value);
+    }
+  }
   _mapped_plot_data.setMaximumRangeX(real_value);
 
   if (_active_streamer_plugin)
   {
-    _active_streamer_plugin->setMaximumRangeX(real_value);
+    // With the archive, the plugin must not discard any data: the expired points
+    // are saved and removed by updateDataAndReplot()
+    _active_streamer_plugin->setMaximumRangeX(
+        _history_archive ? std::numeric_limits<double>::max() : real_value);
   }
 }
 
@@ -2549,6 +2685,11 @@ void MainWindow::on_actionClearBuffer_triggered()
     it.second->reset();
   }
 
+  if (_history_archive)
+  {
+    _history_archive->clear();
+  }
+
   forEachWidget([](PlotWidget* plot) {
     plot->reloadPlotData();
     plot->replot();
@@ -2638,7 +2779,7 @@ void MainWindow::on_pushButtonTimeTracker_pressed()
 
 void MainWindow::closeEvent(QCloseEvent* event)
 {
-  _replot_timer->stop();
+  _replot_scheduler->stop();
   _publish_timer->stop();
 
   if (_active_streamer_plugin)
@@ -2741,10 +2882,10 @@ void MainWindow::onPlaybackLoop()
     it.second->play(_tracker_time);
   }
 
-  forEachWidget([&](PlotWidget* plot) {
-    plot->setTrackerPosition(_tracker_time);
-    plot->replot();
-  });
+  forEachWidget([&](PlotWidget* plot) { plot->setTrackerPosition(_tracker_time); });
+
+  _replot_scheduler->invalidateAll(ReplotScheduler::Change::REPLOT);
+  _replot_scheduler->flush();
 }
 
 void MainWindow::onCustomPlotCreated(std::vector<CustomPlotPtr> custom_plots)
@@ -12,11 +12,11 @@
 #include <functional>
 
 #include <QCommandLineParser>
-#include <QElapsedTimer>
 #include <QMainWindow>
 #include <QSignalMapper>
 #include <QShortcut>
 #include <QMovie>
+#include <QTimer>
 
 #include "plotwidget.h"
 #include "plot_docker.h"
@@ -24,6 +24,9 @@
 #include "tabbedplotwidget.h"
 #include "realslider.h"
 #include "utils.h"
+#include "undo_history.h"
+#include "history_archive.h"
+#include "replot_scheduler.h"
 #include "PlotJuggler/dataloader_base.h"
 #include "PlotJuggler/statepublisher_base.h"
 #include "PlotJuggler/toolbox_base.h"
@@ -57,6 +60,7 @@ public slots:
   void resizeEvent(QResizeEvent*);
   // Undo - Redo
   void onUndoableChange();
+  void saveUndoState();
   void onUndoInvoked();
   void onRedoInvoked();
 
@@ -132,13 +136,19 @@ private:
 
   std::shared_ptr<DataStreamer> _active_streamer_plugin;
 
-  std::deque<QDomDocument> _undo_states;
-  std::deque<QDomDocument> _redo_states;
-  QElapsedTimer _undo_timer;
+  UndoHistory _undo_history;
+
+  // data older than the streaming buffer, if enabled in the preferences
+  std::unique_ptr<HistoryArchive> _history_archive;
+  // changes that are close in time are saved as a single undo state
+  QTimer _undo_timer;
   bool _disable_undo_logging;
 
   bool _test_option;
 
+  // the curves of the plots changed: the time bounds must select them again
+  bool _plotted_series_changed = true;
+
   bool _autostart_publishers;
 
   double _tracker_time;
@@ -153,7 +163,7 @@ private:
 
   MonitoredValue _time_offset;
 
-  QTimer* _replot_timer;
+  ReplotScheduler* _replot_scheduler;
   QTimer* _publish_timer;
   PJ::DelayedCallback _tracker_delay;
 
@@ -184,6 +194,10 @@ private:
   void forEachWidget(std::function<void(PlotWidget*, PlotDocker*, int)> op);
   void forEachWidget(std::function<void(PlotWidget*)> op);
 
+  void updatePlots(const std::vector<PlotWidget*>& plots);
+
+  void linkedZoomOut(PlotDocker* matrix);
+
   void rearrangeGridLayout();
 
   QDomDocument xmlSaveState() const;
@@ -220,6 +234,8 @@ private:
 
   void updateReactivePlots();
 
+  void pageArchivedHistory(double t_min, double t_max);
+
   void dragEnterEvent(QDragEnterEvent* event);
 
   void dropEvent(QDropEvent* event);
@@ -41,6 +41,7 @@
 #include "qwt_date_scale_draw.h"
 #include "suggest_dialog.h"
 #include "transforms/custom_function.h"
+#include "transforms/transform_scheduler.h"
 #include "plotwidget_editor.h"
 #include "plotwidget_transforms.h"
 
@@ -294,7 +295,8 @@ void PlotWidget::canvasContextMenuTriggered(const QPoint& pos)
 }
 
 PlotWidget::CurveInfo* PlotWidget::addCurveXY(std::string name_x, std::string name_y,
-                                              QString curve_name)
+                                              QString curve_name,
+                                              PointSeriesXY::Alignment alignment)
 {
   std::string name = curve_name.toStdString();
 
@@ -355,7 +357,7 @@ PlotWidget::CurveInfo* PlotWidget::addCurveXY(std::string name_x, std::string na
 
   try
   {
-    auto plot_qwt = createCurveXY(&data_x, &data_y);
+    auto plot_qwt = createCurveXY(&data_x, &data_y, alignment);
 
     curve->setPaintAttribute(QwtPlotCurve::ClipPolygons, true);
     curve->setPaintAttribute(QwtPlotCurve::FilterPointsAggressive, true);
@@ -687,6 +689,14 @@ QDomElement PlotWidget::xmlSaveState(QDomDocument& doc) const
       {
         curve_el.setAttribute("curve_x", QString::fromStdString(xy->dataX()->plotName()));
         curve_el.setAttribute("curve_y", QString::fromStdString(xy->dataY()->plotName()));
+        const auto& alignment = xy->alignment();
+        if (alignment.mode != PointSeriesXY::EXACT_TIME)
+        {
+          const bool nearest = (alignment.mode == PointSeriesXY::NEAREST_TIME);
+          curve_el.setAttribute("alignment", nearest ? "nearest" : "interpolated");
+          curve_el.setAttribute("tolerance",
+                                QString::number(alignment.tolerance, 'g', 12));
+        }
       }
     }
     else
@@ -812,7 +822,19 @@ bool PlotWidget::xmlLoadState(QDomElement& plot_widget, bool autozoom)
       }
       else
       {
-        auto curve_it = addCurveXY(curve_x, curve_y, curve_name);
+        PointSeriesXY::Alignment alignment = {};
+        const QString alignment_str = curve_element.attribute("alignment");
+        if (alignment_str == "nearest")
+        {
+          alignment.mode = PointSeriesXY::NEAREST_TIME;
+        }
+        else if (alignment_str == "interpolated")
+        {
+          alignment.mode = PointSeriesXY::INTERPOLATED_TIME;
+        }
+        alignment.tolerance = curve_element.attribute("tolerance", "0").toDouble();
+
+        auto curve_it = addCurveXY(curve_x, curve_y, curve_name, alignment);
         if (!curve_it)
         {
           continue;
@@ -1130,11 +1152,13 @@ Range PlotWidget::getVisualizationRangeY(Range range_X) const
 
 void PlotWidget::updateCurves(bool reset_older_data)
 {
+  std::vector<QwtSeriesWrapper*> series;
+  series.reserve(curveList().size());
   for (auto& it : curveList())
   {
-    auto series = dynamic_cast<QwtSeriesWrapper*>(it.curve->data());
-    series->updateCache(reset_older_data);
+    series.push_back(dynamic_cast<QwtSeriesWrapper*>(it.curve->data()));
   }
+  TransformScheduler::updateCaches(series, reset_older_data);
   updateMaximumZoomArea();
 
   updateStatistics(true);
@@ -1696,27 +1720,42 @@ void PlotWidget::setDefaultRangeX()
 }
 
 QwtSeriesWrapper* PlotWidget::createCurveXY(const PlotData* data_x,
-                                            const PlotData* data_y)
+                                            const PlotData* data_y,
+                                            PointSeriesXY::Alignment alignment)
 {
   PointSeriesXY* output = nullptr;
 
   try
   {
-    output = new PointSeriesXY(data_x, data_y);
+    output = new PointSeriesXY(data_x, data_y, alignment);
   }
   catch (std::runtime_error& ex)
   {
-    if (if_xy_plot_failed_show_dialog)
+    if (!if_xy_plot_failed_show_dialog)
     {
-      QMessageBox msgBox(qwtPlot());
-      msgBox.setWindowTitle("Warnings");
-      msgBox.setText(tr("The creation of the XY plot failed with the following "
-                        "message:\n %1")
-                         .arg(ex.what()));
-      msgBox.addButton("Continue", QMessageBox::AcceptRole);
-      msgBox.exec();
+      throw std::runtime_error("Creation of XY plot failed");
+    }
+    // Series sampled on different clocks can still be aligned in time
+    const double tolerance = PointSeriesXY::SuggestedTolerance(data_x, data_y);
+
+    QMessageBox msgBox(qwtPlot());
+    msgBox.setWindowTitle("Warnings");
+    msgBox.setText(tr("The creation of the XY plot failed with the following "
+                      "message:\n %1\n\n"
+                      "Do you want to match each sample of Y with the nearest sample "
+                      "of X, within %2 seconds?")
+                       .arg(ex.what())
+                       .arg(tolerance));
+    auto align_button = msgBox.addButton("Align by time", QMessageBox::YesRole);
+    msgBox.addButton("Continue", QMessageBox::AcceptRole);
+    msgBox.exec();
+
+    if (msgBox.clickedButton() != align_button)
+    {
+      throw std::runtime_error("Creation of XY plot failed");
     }
-    throw std::runtime_error("Creation of XY plot failed");
+    output = new PointSeriesXY(data_x, data_y,
+                               { PointSeriesXY::NEAREST_TIME, tolerance });
   }
 
   output->setTimeOffset(_time_offset);
@@ -32,6 +32,7 @@
 #include "transforms/custom_function.h"
 
 #include "plot_background.h"
+#include "point_series_xy.h"
 
 class StatisticsDialog;
 
@@ -66,7 +67,8 @@ public:
     return _mapped_data;
   }
 
-  CurveInfo* addCurveXY(std::string name_x, std::string name_y, QString curve_name = "");
+  CurveInfo* addCurveXY(std::string name_x, std::string name_y, QString curve_name = "",
+                        PointSeriesXY::Alignment alignment = {});
 
   CurveInfo* addCurve(const std::string& name, QColor color = Qt::transparent);
 
@@ -212,7 +214,8 @@ private:
 
   void setDefaultRangeX();
 
-  QwtSeriesWrapper* createCurveXY(const PlotData* data_x, const PlotData* data_y);
+  QwtSeriesWrapper* createCurveXY(const PlotData* data_x, const PlotData* data_y,
+                                  PointSeriesXY::Alignment alignment = {});
 
   QwtSeriesWrapper* createTimeSeries(const PlotData* data,
                                      const QString& transform_ID = {}) override;
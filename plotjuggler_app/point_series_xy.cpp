@@ -8,11 +8,16 @@
 #include <cmath>
 #include <cstdlib>
 
-PointSeriesXY::PointSeriesXY(const PlotData* x_axis, const PlotData* y_axis)
+PointSeriesXY::PointSeriesXY(const PlotData* x_axis, const PlotData* y_axis,
+                             Alignment alignment)
   : QwtTimeseries(nullptr)
   , _x_axis(x_axis)
   , _y_axis(y_axis)
   , _cached_curve("", x_axis->group())
+  , _alignment(alignment)
+  , _x_cursor(x_axis)
+  , _y_cursor(y_axis)
+  , _last_time(std::numeric_limits<double>::lowest())
 {
   updateCache(true);
 }
@@ -29,12 +34,18 @@ std::optional<QPointF> PointSeriesXY::sampleFromTime(double t)
     return {};
   }
 
-  int index = _y_axis->getIndexFromX(t);
-  if (index < 0)
+  auto it = std::lower_bound(_cached_time.begin(), _cached_time.end(), t);
+  size_t index = std::distance(_cached_time.begin(), it);
+  if (index >= _cached_time.size())
   {
-    return {};
+    index = _cached_time.size() - 1;
+  }
+  else if (index > 0 &&
+           std::abs(_cached_time[index - 1] - t) < std::abs(_cached_time[index] - t))
+  {
+    index--;
   }
-  const auto& p = _cached_curve.at(size_t(index));
+  const auto& p = _cached_curve.at(index);
   return QPointF(p.x, p.y);
 }
 
@@ -43,33 +54,129 @@ RangeOpt PointSeriesXY::getVisualizationRangeY(Range)
   return _cached_curve.rangeY();
 }
 
-void PointSeriesXY::updateCache(bool reset_old_data)
+void PointSeriesXY::setAlignment(Alignment alignment)
+{
+  _alignment = alignment;
+  updateCache(true);
+}
+
+double PointSeriesXY::SuggestedTolerance(const PlotData* x_axis, const PlotData* y_axis)
+{
+  // the largest of the two average sampling periods
+  double tolerance = 0;
+  for (const PlotData* data : { x_axis, y_axis })
+  {
+    if (data->size() > 1)
+    {
+      const double period = (data->back().x - data->front().x) / double(data->size() - 1);
+      tolerance = std::max(tolerance, period);
+    }
+  }
+  return tolerance;
+}
+
+void PointSeriesXY::clearCache()
 {
   _cached_curve.clear();
+  _cached_time.clear();
+  _x_cursor.reset();
+  _y_cursor.reset();
+  _last_time = std::numeric_limits<double>::lowest();
+}
 
+std::optional<double> PointSeriesXY::alignedX(double t)
+{
+  const double EPS = std::numeric_limits<double>::epsilon();
+  const double tolerance = _alignment.tolerance;
+
+  switch (_alignment.mode)
+  {
+    case EXACT_TIME: {
+      const size_t index = _x_cursor.lowerBound(t);
+      if (index >= _x_axis->size() || std::abs(_x_axis->at(index).x - t) > EPS)
+      {
+        throw std::runtime_error("X and Y axis don't share the same time axis");
+      }
+      return _x_axis->at(index).y;
+    }
+    case NEAREST_TIME: {
+      const auto& p = _x_axis->at(size_t(_x_cursor.nearestIndex(t)));
+      if (std::abs(p.x - t) > tolerance)
+      {
+        return std::nullopt;
+      }
+      return p.y;
+    }
+    case INTERPOLATED_TIME: {
+      const size_t index = _x_cursor.lowerBound(t);
+      if (index >= _x_axis->size())
+      {
+        return std::nullopt;
+      }
+      // an exact match doesn't depend on the previous sample
+      if (_x_axis->at(index).x == t)
+      {
+        return _x_axis->at(index).y;
+      }
+      if (_x_axis->at(index).x - t > tolerance ||
+          (index > 0 && t - _x_axis->at(index - 1).x > tolerance))
+      {
+        return std::nullopt;
+      }
+      return _x_cursor.valueAt(t, AlignmentPolicy::LINEAR);
+    }
+  }
+  return std::nullopt;
+}
+
+void PointSeriesXY::updateCache(bool reset_old_data)
+{
   if (_x_axis == nullptr)
   {
     throw std::runtime_error("the X axis is null");
   }
 
-  const size_t data_size = std::min(_x_axis->size(), _y_axis->size());
-
-  if (data_size == 0)
+  if (_x_axis->size() == 0 || _y_axis->size() == 0)
   {
+    clearCache();
     return;
   }
 
-  const double EPS = std::numeric_limits<double>::epsilon();
+  // the data was cleared or replaced: start from scratch
+  if (reset_old_data || _y_axis->back().x < _last_time)
+  {
+    clearCache();
+  }
 
-  for (size_t i = 0; i < data_size; i++)
+  // the oldest samples were removed from the sources (maximum range)
+  const double first_time = std::max(_x_axis->front().x, _y_axis->front().x);
+  while (!_cached_time.empty() && _cached_time.front() < first_time)
   {
-    if (std::abs(_x_axis->at(i).x - _y_axis->at(i).x) > EPS)
+    _cached_time.pop_front();
+    _cached_curve.popFront();
+  }
+
+  // a sample of Y can be matched only when X has been received up to its time,
+  // otherwise the match might change when new samples of X arrive.
+  const double last_x_time = _x_axis->back().x;
+
+  for (size_t index = _y_cursor.upperBound(_last_time); index < _y_axis->size();
+       index++)
+  {
+    const auto& p = _y_axis->at(index);
+    if (p.x > last_x_time)
     {
-      throw std::runtime_error("X and Y axis don't share the same time axis");
+      break;
     }
-
-    const QPointF p(_x_axis->at(i).y, _y_axis->at(i).y);
-    _cached_curve.pushBack({ p.x(), p.y() });
+    // if alignedX() throws, the same sample is checked again at the next update
+    auto x_value = alignedX(p.x);
+    _last_time = p.x;
+    if (!x_value || !std::isfinite(*x_value) || !std::isfinite(p.y))
+    {
+      continue;
+    }
+    _cached_curve.pushBack({ *x_value, p.y });
+    _cached_time.push_back(p.x);
   }
 }
 
@@ -7,12 +7,32 @@
 #ifndef POINT_SERIES_H
 #define POINT_SERIES_H
 
+#include <deque>
 #include "timeseries_qwt.h"
+#include "PlotJuggler/util/time_alignment.hpp"
 
 class PointSeriesXY : public QwtTimeseries
 {
 public:
-  PointSeriesXY(const PlotData* x_axis, const PlotData* y_axis);
+  /// How a sample of Y is matched with a sample of X.
+  enum AlignmentMode
+  {
+    // X and Y must have the same timestamps
+    EXACT_TIME,
+    // X is sampled at the nearest timestamp, if closer than the tolerance
+    NEAREST_TIME,
+    // X is interpolated, if both the samples around it are within the tolerance
+    INTERPOLATED_TIME
+  };
+
+  // Alignment{} is EXACT_TIME
+  struct Alignment
+  {
+    AlignmentMode mode;
+    double tolerance;
+  };
+
+  PointSeriesXY(const PlotData* x_axis, const PlotData* y_axis, Alignment alignment = {});
 
   virtual QPointF sample(size_t i) const override
   {
@@ -26,6 +46,7 @@ public:
 
   RangeOpt getVisualizationRangeY(Range range_X) override;
 
+  /// Only the new samples are appended, unless reset_old_data is true.
   void updateCache(bool reset_old_data) override;
 
   RangeOpt getVisualizationRangeX() override;
@@ -44,10 +65,33 @@ public:
     return &_cached_curve;
   }
 
+  const Alignment& alignment() const
+  {
+    return _alignment;
+  }
+
+  /// Change the alignment and rebuild the cache.
+  void setAlignment(Alignment alignment);
+
+  /// Tolerance that can be used to align two series sampled at different rates.
+  static double SuggestedTolerance(const PlotData* x_axis, const PlotData* y_axis);
+
 protected:
   const PlotData* _x_axis;
   const PlotData* _y_axis;
   PlotDataXY _cached_curve;
+  // timestamp of each point in _cached_curve
+  std::deque<double> _cached_time;
+
+  Alignment _alignment;
+  TimeseriesCursor _x_cursor;
+  TimeseriesCursor _y_cursor;
+  // timestamp of the last sample of Y that was processed
+  double _last_time;
+
+  void clearCache();
+
+  std::optional<double> alignedX(double t);
 };
 
 #endif  // POINT_SERIES_H
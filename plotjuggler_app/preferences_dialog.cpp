@@ -43,6 +43,12 @@ PreferencesDialog::PreferencesDialog(QWidget* parent)
   bool use_opengl = settings.value("Preferences::use_opengl", true).toBool();
   ui->checkBoxOpenGL->setChecked(use_opengl);
 
+  bool parallel_render = settings.value("Preferences::parallel_render", false).toBool();
+  ui->checkBoxParallelRender->setChecked(parallel_render);
+  ui->checkBoxParallelRender->setEnabled(!use_opengl);
+  connect(ui->checkBoxOpenGL, &QCheckBox::toggled, ui->checkBoxParallelRender,
+          [this](bool checked) { ui->checkBoxParallelRender->setEnabled(!checked); });
+
   bool autozoom_visibility = settings.value("Preferences::autozoom_visibility",true).toBool();
   ui->checkBoxAutoZoomVisibility->setChecked(autozoom_visibility);
 
@@ -52,6 +58,9 @@ PreferencesDialog::PreferencesDialog(QWidget* parent)
   bool autozoom_filter_applied = settings.value("Preferences::autozoom_filter_applied",true).toBool();
   ui->checkBoxAutoZoomFilter->setChecked(autozoom_filter_applied);
 
+  bool spill_history = settings.value("Preferences::spill_history", false).toBool();
+  ui->checkBoxSpillHistory->setChecked(spill_history);
+
   //---------------
   auto custom_plugin_folders =
       settings.value("Preferences::plugin_folders", true).toStringList();
@@ -91,9 +100,12 @@ void PreferencesDialog::on_buttonBox_accepted()
                     ui->radioLocalColorIndex->isChecked());
   settings.setValue("Preferences::use_separator", ui->checkBoxSeparator->isChecked());
   settings.setValue("Preferences::use_opengl", ui->checkBoxOpenGL->isChecked());
+  settings.setValue("Preferences::parallel_render",
+                    ui->checkBoxParallelRender->isChecked());
   settings.setValue("Preferences::autozoom_visibility", ui->checkBoxAutoZoomVisibility->isChecked());
   settings.setValue("Preferences::autozoom_curve_added", ui->checkBoxAutoZoomAdded->isChecked());
   settings.setValue("Preferences::autozoom_filter_applied", ui->checkBoxAutoZoomFilter->isChecked());
+  settings.setValue("Preferences::spill_history", ui->checkBoxSpillHistory->isChecked());
 
   QStringList plugin_folders;
   for (int row = 0; row < ui->listWidgetCustom->count(); row++)
@@ -0,0 +1,195 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "replot_scheduler.h"
+#include <algorithm>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QGuiApplication>
+#include <QScreen>
+#include "plotwidget.h"
+
+namespace
+{
+ReplotScheduler::Change Max(ReplotScheduler::Change a, ReplotScheduler::Change b)
+{
+  return (int(a) >= int(b)) ? a : b;
+}
+
+double FramePeriodMs()
+{
+  QScreen* screen = QGuiApplication::primaryScreen();
+  const double refresh_rate = screen ? screen->refreshRate() : 0.0;
+  return 1000.0 / (refresh_rate > 1.0 ? refresh_rate : 60.0);
+}
+}  // namespace
+
+ReplotScheduler::ReplotScheduler(WidgetVisitor for_each_widget,
+                                 UpdateFunction update_plots, QObject* parent)
+  : QObject(parent)
+  , _for_each_widget(std::move(for_each_widget))
+  , _update_plots(std::move(update_plots))
+{
+  _timer.setSingleShot(true);
+  connect(&_timer, &QTimer::timeout, this, &ReplotScheduler::updateRequested);
+}
+
+void ReplotScheduler::requestUpdate()
+{
+  if (!_timer.isActive())
+  {
+    _timer.start(interval());
+  }
+}
+
+void ReplotScheduler::stop()
+{
+  _timer.stop();
+}
+
+int ReplotScheduler::interval() const
+{
+  // one update per frame at most, leaving to the rest of the GUI at least
+  // half of the time
+  const double interval = std::max(FramePeriodMs(), 2.0 * _render_cost_ms);
+  return int(std::min(interval, MAX_INTERVAL_MS));
+}
+
+void ReplotScheduler::seriesChanged(const std::string& name, Change change)
+{
+  auto& value = _changed_series[name];
+  value = Max(value, change);
+}
+
+void ReplotScheduler::invalidateAll(Change change)
+{
+  _all_changed = Max(_all_changed, change);
+}
+
+ReplotScheduler::Change ReplotScheduler::pendingChange(PlotWidget* plot) const
+{
+  Change change = _all_changed;
+
+  auto hidden_it = _hidden.find(plot);
+  if (hidden_it != _hidden.end())
+  {
+    change = Max(change, hidden_it->second.change);
+  }
+  if (_changed_series.empty())
+  {
+    return change;
+  }
+  // the curves of a XY plot are not named after their source series
+  if (plot->isXYPlot())
+  {
+    for (const auto& it : _changed_series)
+    {
+      change = Max(change, it.second);
+    }
+    return change;
+  }
+  for (const auto& curve : plot->curveList())
+  {
+    auto it = _changed_series.find(curve.src_name);
+    if (it != _changed_series.end())
+    {
+      change = Max(change, it->second);
+    }
+  }
+  return change;
+}
+
+void ReplotScheduler::flush()
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  std::vector<PlotWidget*> to_update;
+  std::vector<PlotWidget*> to_replot;
+
+  _for_each_widget([&](PlotWidget* plot) {
+    const Change change = pendingChange(plot);
+    if (change == Change::NONE)
+    {
+      return;
+    }
+    if (!plot->isVisible())
+    {
+      markHidden(plot, change);
+      return;
+    }
+    clearHidden(plot);
+    if (change == Change::UPDATE)
+    {
+      to_update.push_back(plot);
+    }
+    else
+    {
+      to_replot.push_back(plot);
+    }
+  });
+
+  _changed_series.clear();
+  _all_changed = Change::NONE;
+
+  if (to_update.empty() && to_replot.empty())
+  {
+    return;
+  }
+  if (!to_update.empty())
+  {
+    _update_plots(to_update);
+  }
+  for (PlotWidget* plot : to_replot)
+  {
+    plot->replot();
+  }
+
+  const double cost = timer.nsecsElapsed() * 1e-6;
+  _render_cost_ms = (_render_cost_ms == 0) ? cost : (0.8 * _render_cost_ms + 0.2 * cost);
+}
+
+void ReplotScheduler::markHidden(PlotWidget* plot, Change change)
+{
+  auto it = _hidden.find(plot);
+  if (it != _hidden.end())
+  {
+    it->second.change = Max(it->second.change, change);
+    return;
+  }
+  HiddenPlot hidden;
+  hidden.change = change;
+  hidden.destroyed = connect(plot, &QObject::destroyed, this,
+                             [this, plot]() { _hidden.erase(plot); });
+  _hidden.insert({ plot, hidden });
+  plot->installEventFilter(this);
+}
+
+void ReplotScheduler::clearHidden(PlotWidget* plot)
+{
+  auto it = _hidden.find(plot);
+  if (it == _hidden.end())
+  {
+    return;
+  }
+  disconnect(it->second.destroyed);
+  plot->removeEventFilter(this);
+  _hidden.erase(it);
+}
+
+bool ReplotScheduler::eventFilter(QObject* object, QEvent* event)
+{
+  // many plots are shown together when a tab is selected: refresh them at once
+  if (event->type() == QEvent::Show && !_flush_posted)
+  {
+    _flush_posted = true;
+    QTimer::singleShot(0, this, [this]() {
+      _flush_posted = false;
+      flush();
+    });
+  }
+  return QObject::eventFilter(object, event);
+}
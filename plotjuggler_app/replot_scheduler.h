@@ -0,0 +1,103 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef REPLOT_SCHEDULER_H
+#define REPLOT_SCHEDULER_H
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <QObject>
+#include <QTimer>
+
+class PlotWidget;
+
+/**
+ * @brief Decides which plots must be redrawn, and when.
+ *
+ * The changes are collected per series; when flush() is called, only the plots
+ * that show one of the changed series are refreshed, and only if they are visible.
+ * The plots in hidden tabs or docks are remembered and refreshed once they are shown.
+ *
+ * While streaming, requestUpdate() coalesces the notifications of new data: the
+ * update is triggered at most once per frame of the display, or less often if
+ * refreshing the plots takes a large fraction of that time.
+ */
+class ReplotScheduler : public QObject
+{
+  Q_OBJECT
+
+public:
+  enum class Change
+  {
+    NONE = 0,
+    // the curve must be drawn again, for instance because the tracker moved
+    REPLOT = 1,
+    // the data changed: caches and zoom must be updated too
+    UPDATE = 2
+  };
+
+  using WidgetVisitor = std::function<void(std::function<void(PlotWidget*)>)>;
+  /// Update the caches and the zoom of the plots, then replot them.
+  using UpdateFunction = std::function<void(const std::vector<PlotWidget*>&)>;
+
+  // longest interval between two updates, even if rendering is slow
+  static constexpr double MAX_INTERVAL_MS = 500;
+
+  ReplotScheduler(WidgetVisitor for_each_widget, UpdateFunction update_plots,
+                  QObject* parent = nullptr);
+
+  /// Emit updateRequested() once, after interval() milliseconds.
+  void requestUpdate();
+
+  /// Cancel a pending updateRequested().
+  void stop();
+
+  int interval() const;
+
+  void seriesChanged(const std::string& name, Change change);
+
+  void invalidateAll(Change change);
+
+  /// Refresh the visible plots affected by the changes collected so far.
+  void flush();
+
+signals:
+
+  void updateRequested();
+
+protected:
+  bool eventFilter(QObject* object, QEvent* event) override;
+
+private:
+  WidgetVisitor _for_each_widget;
+  UpdateFunction _update_plots;
+  QTimer _timer;
+
+  std::unordered_map<std::string, Change> _changed_series;
+  Change _all_changed = Change::NONE;
+
+  // plots that could not be refreshed because they were hidden
+  struct HiddenPlot
+  {
+    Change change;
+    QMetaObject::Connection destroyed;
+  };
+  std::unordered_map<PlotWidget*, HiddenPlot> _hidden;
+  bool _flush_posted = false;
+
+  // moving average of the time spent in flush()
+  double _render_cost_ms = 0;
+
+  Change pendingChange(PlotWidget* plot) const;
+
+  void markHidden(PlotWidget* plot, Change change);
+
+  void clearHidden(PlotWidget* plot);
+};
+
+#endif  // REPLOT_SCHEDULER_H
@@ -7,7 +7,75 @@
 #include "statistics_dialog.h"
 #include "ui_statistics_dialog.h"
 #include <QTableWidgetItem>
+#include <QtConcurrent>
 #include "qwt_text.h"
+#include "timeseries_qwt.h"
+#include "point_series_xy.h"
+
+namespace
+{
+ValueSummary Summarize(const QwtSeriesData<QPointF>* data, Range range,
+                       bool visible_range)
+{
+  // PointSeriesXY is a QwtTimeseries too, but its points are not sorted by X
+  const bool sorted_x = (dynamic_cast<const PointSeriesXY*>(data) == nullptr);
+
+  // Timeseries are sorted by time: the visible samples are found with a binary
+  // search and their summary is mostly made of the precomputed summaries of blocks.
+  auto ts = sorted_x ? dynamic_cast<const QwtTimeseries*>(data) : nullptr;
+  if (ts)
+  {
+    const PlotDataXY* plot_data = ts->plotData();
+    if (plot_data->size() == 0)
+    {
+      return {};
+    }
+    size_t first = 0;
+    size_t last = plot_data->size() - 1;
+    if (visible_range)
+    {
+      using Point = PlotDataXY::Point;
+      const double offset = ts->timeOffset();
+      auto from = std::lower_bound(plot_data->begin(), plot_data->end(),
+                                   range.min + offset,
+                                   [](const Point& p, double x) { return p.x < x; });
+      auto to = std::upper_bound(plot_data->begin(), plot_data->end(),
+                                 range.max + offset,
+                                 [](double x, const Point& p) { return x < p.x; });
+      if (from >= to)
+      {
+        return {};
+      }
+      first = size_t(from - plot_data->begin());
+      last = size_t(to - plot_data->begin()) - 1;
+    }
+    return plot_data->summaryY(first, last);
+  }
+
+  ValueSummary summary;
+  for (size_t i = 0; i < data->size(); i++)
+  {
+    const auto p = data->sample(i);
+    if (visible_range)
+    {
+      if (p.x() < range.min)
+      {
+        continue;
+      }
+      if (p.x() > range.max)
+      {
+        if (sorted_x)
+        {
+          break;
+        }
+        continue;
+      }
+    }
+    summary.add(p.y());
+  }
+  return summary;
+}
+}  // namespace
 
 StatisticsDialog::StatisticsDialog(PlotWidget* parent)
   : QDialog(parent), ui(new Ui::statistics_dialog), _parent(parent)
@@ -38,59 +106,41 @@ bool StatisticsDialog::calcVisibleRange()
 
 void StatisticsDialog::update(PJ::Range range)
 {
-  std::map<QString, Statistics> statistics;
-
+  struct CurveSummary
+  {
+    QString name;
+    const QwtSeriesData<QPointF>* data;
+    ValueSummary summary;
+  };
+  std::vector<CurveSummary> curves;
   for (const auto& info : _parent->curveList())
   {
-    Statistics stat;
-    const auto ts = info.curve->data();
+    curves.push_back({ info.curve->title().text(), info.curve->data(), {} });
+  }
 
-    bool first = true;
+  // each curve has its own data, therefore they can be summarized in parallel
+  const bool visible_range = calcVisibleRange();
+  QtConcurrent::blockingMap(curves, [&](CurveSummary& curve) {
+    curve.summary = Summarize(curve.data, range, visible_range);
+  });
 
-    for (size_t i = 0; i < ts->size(); i++)
-    {
-      const auto p = ts->sample(i);
-      if (calcVisibleRange())
-      {
-        if (p.x() < range.min)
-        {
-          continue;
-        }
-        if (p.x() > range.max)
-        {
-          break;
-        }
-      }
-      stat.count++;
-      if (first)
-      {
-        stat.min = p.y();
-        stat.max = p.y();
-        first = false;
-      }
-      else
-      {
-        stat.min = std::min(stat.min, p.y());
-        stat.max = std::max(stat.max, p.y());
-      }
-      stat.mean_tot += p.y();
-    }
-    statistics[info.curve->title().text()] = stat;
-  }
+  std::sort(curves.begin(), curves.end(),
+            [](const CurveSummary& a, const CurveSummary& b) { return a.name < b.name; });
 
-  ui->tableWidget->setRowCount(statistics.size());
+  ui->tableWidget->setRowCount(curves.size());
   int row = 0;
-  for (const auto& it : statistics)
+  for (const auto& curve : curves)
   {
-    const auto& stat = it.second;
+    const auto& stat = curve.summary;
 
-    std::array<QString, 5> row_values;
-    row_values[0] = it.first;
+    std::array<QString, 7> row_values;
+    row_values[0] = curve.name;
     row_values[1] = QString::number(stat.count);
     row_values[2] = QString::number(stat.min, 'f');
     row_values[3] = QString::number(stat.max, 'f');
-    double mean = stat.mean_tot / double(stat.count);
-    row_values[4] = QString::number(mean, 'f');
+    row_values[4] = QString::number(stat.mean(), 'f');
+    row_values[5] = QString::number(stat.stdDev(), 'f');
+    row_values[6] = QString::number(stat.rms(), 'f');
 
     for (size_t col = 0; col < row_values.size(); col++)
     {
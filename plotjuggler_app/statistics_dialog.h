@@ -17,14 +17,6 @@ namespace Ui
 class statistics_dialog;
 }
 
-struct Statistics
-{
-  size_t count = 0;
-  double min = 0;
-  double max = 0;
-  double mean_tot = 0;
-};
-
 class StatisticsDialog : public QDialog
 {
   Q_OBJECT
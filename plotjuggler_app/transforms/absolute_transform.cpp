@@ -8,3 +8,16 @@ std::optional<PlotData::Point> AbsoluteTransform::calculateNextPoint(size_t inde
   PlotData::Point out = { p.x, std::abs(p.y) };
   return out;
 }
+
+void AbsoluteTransform::calculateBatch(size_t, const PlotData::Point* input,
+                                       size_t count, std::vector<PlotData::Point>& output)
+{
+  const size_t offset = output.size();
+  output.resize(offset + count);
+  PlotData::Point* out = output.data() + offset;
+  for (size_t i = 0; i < count; i++)
+  {
+    out[i].x = input[i].x;
+    out[i].y = std::abs(input[i].y);
+  }
+}
@@ -18,8 +18,16 @@ public:
     return "Absolute";
   }
 
+  bool isThreadSafe() const override
+  {
+    return true;
+  }
+
 private:
   std::optional<PlotData::Point> calculateNextPoint(size_t index) override;
+
+  void calculateBatch(size_t first_index, const PlotData::Point* input, size_t count,
+                      std::vector<PlotData::Point>& output) override;
 };
 
 #endif  // ABSOLUTE_TRANSFORM_H
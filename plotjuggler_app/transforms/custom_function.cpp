@@ -66,17 +66,15 @@ const SnippetData& CustomFunction::snippet() const
   return _snippet;
 }
 
-void CustomFunction::calculate()
+bool CustomFunction::updateDataSources()
 {
-  auto dst_data = _dst_vector.front();
+  _src_vector.clear();
 
   auto data_it = plotData()->numeric.find(_linked_plot_name);
   if (data_it == plotData()->numeric.end())
   {
-    // failed! keep it empty
-    return;
+    return false;
   }
-  _src_vector.clear();
   _src_vector.push_back(&data_it->second);
 
   for (const auto& channel : _used_channels)
@@ -89,6 +87,18 @@ void CustomFunction::calculate()
     const PlotData* chan_data = &(it->second);
     _src_vector.push_back(chan_data);
   }
+  return true;
+}
+
+void CustomFunction::calculate()
+{
+  auto dst_data = _dst_vector.front();
+
+  if (!updateDataSources())
+  {
+    // failed! keep it empty
+    return;
+  }
 
   const PlotData* main_data_source = _src_vector.front();
 
@@ -101,19 +111,32 @@ void CustomFunction::calculate()
     last_updated_stamp = dst_data->back().x;
   }
 
+  // usually the cursor is already there: O(1) instead of scanning the series
+  _main_cursor.setSeries(main_data_source);
+  size_t index = _main_cursor.upperBound(last_updated_stamp);
+
   std::vector<PlotData::Point> points;
-  for (size_t i = 0; i < main_data_source->size(); ++i)
+  while (index < main_data_source->size())
   {
-    if (main_data_source->at(i).x > last_updated_stamp)
-    {
-      points.clear();
-      calculatePoints(_src_vector, i, points);
+    const size_t last = std::min(index + CHUNK_SIZE, main_data_source->size());
+    points.clear();
+    calculateChunk(_src_vector, index, last, points);
 
-      for (PlotData::Point const& point : points)
-      {
-        dst_data->pushBack(point);
-      }
+    for (PlotData::Point const& point : points)
+    {
+      dst_data->pushBack(point);
     }
+    index = last;
+  }
+}
+
+void CustomFunction::calculateChunk(const std::vector<const PlotData*>& src_data,
+                                    size_t first_index, size_t last_index,
+                                    std::vector<PlotData::Point>& new_points)
+{
+  for (size_t i = first_index; i < last_index; i++)
+  {
+    calculatePoints(src_data, i, new_points);
   }
 }
 
@@ -188,6 +211,7 @@ SnippetData GetSnippetFromXML(const QDomElement& element)
   snippet.alias_name = element.attribute("name");
   snippet.global_vars = element.firstChildElement("global").text().trimmed();
   snippet.function = element.firstChildElement("function").text().trimmed();
+  snippet.vectorized = (element.attribute("vectorized") == "true");
 
   auto additional_el = element.firstChildElement("additional_sources");
   if (!additional_el.isNull())
@@ -210,6 +234,10 @@ QDomElement ExportSnippetToXML(const SnippetData& snippet, QDomDocument& doc)
   auto element = doc.createElement("snippet");
 
   element.setAttribute("name", snippet.alias_name);
+  if (snippet.vectorized)
+  {
+    element.setAttribute("vectorized", "true");
+  }
 
   auto global_el = doc.createElement("global");
   global_el.appendChild(doc.createTextNode(snippet.global_vars));
@@ -9,6 +9,7 @@
 #include <QString>
 #include "PlotJuggler/plotdata.h"
 #include "PlotJuggler/transform_function.h"
+#include "PlotJuggler/util/time_alignment.hpp"
 
 using namespace PJ;
 
@@ -23,6 +24,8 @@ struct SnippetData
   QString function;
   QString linked_source;
   QStringList additional_sources;
+  // if true, the function receives arrays of samples instead of single values
+  bool vectorized = false;
 };
 
 typedef std::map<QString, SnippetData> SnippetsMap;
@@ -61,6 +64,10 @@ public:
     return _snippet.alias_name;
   }
 
+  /// Find the source series in plotData(). Return false if the linked source
+  /// doesn't exist (yet).
+  bool updateDataSources();
+
   void calculate() override;
 
   bool xmlSaveState(QDomDocument& doc, QDomElement& parent_element) const override;
@@ -79,10 +86,23 @@ public:
                                size_t point_index,
                                std::vector<PlotData::Point>& new_points) = 0;
 
+  /// Process the points [first_index, last_index) of the main source.
+  /// The default implementation calls calculatePoints() for each of them.
+  virtual void calculateChunk(const std::vector<const PlotData*>& src_data,
+                              size_t first_index, size_t last_index,
+                              std::vector<PlotData::Point>& new_points);
+
 protected:
+  static constexpr size_t CHUNK_SIZE = 4096;
+
   SnippetData _snippet;
   std::string _linked_plot_name;
   std::string _plot_name;
 
   std::vector<std::string> _used_channels;
+
+  // position of the last processed point in the main source
+  TimeseriesCursor _main_cursor;
+  // align the sources to the time of the main one
+  TimeAligner _aligner;
 };
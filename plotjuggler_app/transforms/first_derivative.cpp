@@ -62,6 +62,50 @@ std::optional<PlotData::Point> FirstDerivative::calculateNextPoint(size_t index)
   return out;
 }
 
+void FirstDerivative::calculateBatch(size_t first_index, const PlotData::Point* input,
+                                     size_t count, std::vector<PlotData::Point>& output)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  // the first point of the block depends on the previous block
+  auto first_point = calculateNextPoint(first_index);
+  if (first_point)
+  {
+    output.push_back(first_point.value());
+  }
+
+  const size_t offset = output.size();
+
+  if (_dT > 0.0)
+  {
+    // constant dt: no point is discarded and the loop can be vectorized
+    const double dt = _dT;
+    output.resize(offset + count - 1);
+    PlotData::Point* out = output.data() + offset;
+    for (size_t i = 1; i < count; i++)
+    {
+      out[i - 1].x = input[i - 1].x;
+      out[i - 1].y = (input[i].y - input[i - 1].y) / dt;
+    }
+  }
+  else if (_dT == 0.0)
+  {
+    output.reserve(offset + count - 1);
+    for (size_t i = 1; i < count; i++)
+    {
+      const auto& prev = input[i - 1];
+      const auto& p = input[i];
+      const double dt = p.x - prev.x;
+      if (dt > 0)
+      {
+        output.emplace_back(prev.x, (p.y - prev.y) / dt);
+      }
+    }
+  }
+}
+
 QWidget* FirstDerivative::optionsWidget()
 {
   const size_t data_size = dataSource()->size();
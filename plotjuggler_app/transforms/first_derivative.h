@@ -19,6 +19,11 @@ public:
     return "Derivative";
   }
 
+  bool isThreadSafe() const override
+  {
+    return true;
+  }
+
   QWidget* optionsWidget() override;
 
   bool xmlSaveState(QDomDocument& doc, QDomElement& parent_element) const override;
@@ -30,6 +35,9 @@ public:
 private:
   std::optional<PlotData::Point> calculateNextPoint(size_t index) override;
 
+  void calculateBatch(size_t first_index, const PlotData::Point* input, size_t count,
+                      std::vector<PlotData::Point>& output) override;
+
   QWidget* _widget;
   Ui::FirstDerivariveForm* ui;
   double _dT;
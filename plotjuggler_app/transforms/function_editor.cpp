@@ -250,6 +250,7 @@ void FunctionEditorWidget::editExistingPlot(CustomPlotPtr data)
 {
   ui->globalVarsText->setPlainText(data->snippet().global_vars);
   ui->functionText->setPlainText(data->snippet().function);
+  ui->checkBoxVectorized->setChecked(data->snippet().vectorized);
   setLinkedPlotName(data->snippet().linked_source);
   ui->nameLineEdit->setText(data->aliasName());
   ui->nameLineEdit->setEnabled(false);
@@ -375,6 +376,7 @@ void FunctionEditorWidget::importSnippets(const QByteArray& xml_text)
 
     snippet.global_vars = math_plot->snippet().global_vars;
     snippet.function = math_plot->snippet().function;
+    snippet.vectorized = math_plot->snippet().vectorized;
   }
   ui->snippetsListSaved->sortItems();
 }
@@ -427,6 +429,7 @@ void FunctionEditorWidget::on_snippetsListSaved_doubleClicked(const QModelIndex&
 
   ui->globalVarsText->setPlainText(snippet.global_vars);
   ui->functionText->setPlainText(snippet.function);
+  ui->checkBoxVectorized->setChecked(snippet.vectorized);
 }
 
 void FunctionEditorWidget::savedContextMenu(const QPoint& pos)
@@ -554,6 +557,7 @@ void FunctionEditorWidget::on_buttonSaveCurrent_clicked()
   snippet.alias_name = name;
   snippet.global_vars = ui->globalVarsText->toPlainText();
   snippet.function = ui->functionText->toPlainText();
+  snippet.vectorized = ui->checkBoxVectorized->isChecked();
 
   addToSaved(name, snippet);
 
@@ -643,6 +647,7 @@ void FunctionEditorWidget::on_pushButtonCreate_clicked()
       SnippetData snippet;
       snippet.function = ui->functionText->toPlainText();
       snippet.global_vars = ui->globalVarsText->toPlainText();
+      snippet.vectorized = ui->checkBoxVectorized->isChecked();
       snippet.alias_name = ui->nameLineEdit->text();
       snippet.linked_source = getLinkedData();
       for (int row = 0; row < ui->listAdditionalSources->rowCount(); row++)
@@ -659,6 +664,7 @@ void FunctionEditorWidget::on_pushButtonCreate_clicked()
         SnippetData snippet;
         snippet.function = ui->functionTextBatch->toPlainText();
         snippet.global_vars = ui->globalVarsTextBatch->toPlainText();
+        snippet.vectorized = ui->checkBoxVectorized->isChecked();
         snippet.linked_source = ui->listBatchSources->item(row)->text();
         if (ui->radioButtonPrefix->isChecked())
         {
@@ -810,6 +816,7 @@ void FunctionEditorWidget::onUpdatePreview()
   SnippetData snippet;
   snippet.function = ui->functionText->toPlainText();
   snippet.global_vars = ui->globalVarsText->toPlainText();
+  snippet.vectorized = ui->checkBoxVectorized->isChecked();
   snippet.alias_name = ui->nameLineEdit->text();
   snippet.linked_source = getLinkedData();
   for (int row = 0; row < ui->listAdditionalSources->rowCount(); row++)
@@ -871,6 +878,7 @@ void FunctionEditorWidget::onUpdatePreviewBatch()
   SnippetData snippet;
   snippet.function = ui->functionTextBatch->toPlainText();
   snippet.global_vars = ui->globalVarsTextBatch->toPlainText();
+  snippet.vectorized = ui->checkBoxVectorized->isChecked();
 
   try
   {
@@ -987,3 +995,8 @@ void FunctionEditorWidget::on_functionText_textChanged()
 {
   _update_preview_tab1.triggerSignal(250);
 }
+
+void FunctionEditorWidget::on_checkBoxVectorized_toggled(bool)
+{
+  _update_preview_tab1.triggerSignal(250);
+}
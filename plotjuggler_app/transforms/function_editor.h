@@ -105,6 +105,8 @@ private slots:
 
   void on_functionText_textChanged();
 
+  void on_checkBoxVectorized_toggled(bool checked);
+
 private:
   void importSnippets(const QByteArray& xml_text);
 
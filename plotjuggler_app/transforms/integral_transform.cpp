@@ -63,6 +63,37 @@ std::optional<PlotData::Point> IntegralTransform::calculateNextPoint(size_t inde
   return out;
 }
 
+void IntegralTransform::calculateBatch(size_t first_index, const PlotData::Point* input,
+                                       size_t count, std::vector<PlotData::Point>& output)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  // the first point of the block depends on the previous block
+  auto first_point = calculateNextPoint(first_index);
+  if (first_point)
+  {
+    output.push_back(first_point.value());
+  }
+
+  output.reserve(output.size() + count - 1);
+  double accumulated = _accumulated_value;
+
+  for (size_t i = 1; i < count; i++)
+  {
+    const auto& prev = input[i - 1];
+    const auto& p = input[i];
+    const double dt = (_dT == 0.0) ? (p.x - prev.x) : _dT;
+    if (dt > 0)
+    {
+      accumulated += (p.y + prev.y) * dt / (2.0);
+      output.emplace_back(p.x, accumulated);
+    }
+  }
+  _accumulated_value = accumulated;
+}
+
 QWidget* IntegralTransform::optionsWidget()
 {
   const size_t data_size = dataSource()->size();
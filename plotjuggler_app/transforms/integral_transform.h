@@ -19,6 +19,11 @@ public:
     return "Integral";
   }
 
+  bool isThreadSafe() const override
+  {
+    return true;
+  }
+
   QWidget* optionsWidget() override;
 
   void reset() override;
@@ -32,6 +37,9 @@ public:
 private:
   std::optional<PlotData::Point> calculateNextPoint(size_t index) override;
 
+  void calculateBatch(size_t first_index, const PlotData::Point* input, size_t count,
+                      std::vector<PlotData::Point>& output) override;
+
   QWidget* _widget;
   Ui::IntegralTransform* ui;
   double _dT;
@@ -50,6 +50,15 @@ void LuaCustomFunction::initEngine()
     throw std::runtime_error(getError(err));
   }
   _lua_function = _lua_engine["calc"];
+
+  // Simple functions without global variables don't need Lua at all.
+  // The Lua engine is still initialized above to validate the code.
+  _native_expression.reset();
+  if (_snippet.global_vars.trimmed().isEmpty())
+  {
+    _native_expression = NativeExpression::compile(_snippet.function.toStdString(),
+                                                   _snippet.additional_sources.size());
+  }
 }
 
 void LuaCustomFunction::calculatePoints(const std::vector<const PlotData*>& src_data,
@@ -62,21 +71,8 @@ void LuaCustomFunction::calculatePoints(const std::vector<const PlotData*>& src_
 
   const PlotData::Point& old_point = src_data.front()->at(point_index);
 
-  for (size_t chan_index = 0; chan_index < src_data.size(); chan_index++)
-  {
-    double value;
-    const PlotData* chan_data = src_data[chan_index];
-    int index = chan_data->getIndexFromX(old_point.x);
-    if (index != -1)
-    {
-      value = chan_data->at(index).y;
-    }
-    else
-    {
-      value = std::numeric_limits<double>::quiet_NaN();
-    }
-    _chan_values[chan_index] = value;
-  }
+  _aligner.setSeries(src_data);
+  _aligner.valuesAt(old_point.x, _chan_values.data());
 
   sol::safe_function_result result;
   const auto& v = _chan_values;
@@ -138,10 +134,7 @@ void LuaCustomFunction::calculatePoints(const std::vector<const PlotData*>& src_
   }
   else if (result.return_count() == 1 && result.get_type(0) == sol::type::table)
   {
-    static std::vector<std::array<double, 2>> multi_samples;
-    multi_samples.clear();
-
-    multi_samples = result.get<std::vector<std::array<double, 2>>>(0);
+    auto multi_samples = result.get<std::vector<std::array<double, 2>>>(0);
 
     for (std::array<double, 2> sample : multi_samples)
     {
@@ -159,6 +152,123 @@ void LuaCustomFunction::calculatePoints(const std::vector<const PlotData*>& src_
   }
 }
 
+void LuaCustomFunction::calculateChunk(const std::vector<const PlotData*>& src_data,
+                                       size_t first_index, size_t last_index,
+                                       std::vector<PlotData::Point>& points)
+{
+  if (!_snippet.vectorized && !_native_expression)
+  {
+    CustomFunction::calculateChunk(src_data, first_index, last_index, points);
+    return;
+  }
+
+  std::unique_lock<std::mutex> lk(mutex_);
+
+  alignChunk(src_data, first_index, last_index);
+  const size_t count = last_index - first_index;
+  const auto& time = _chunk_values[0];
+
+  if (!_snippet.vectorized)
+  {
+    // same result of calculatePoints(), without the overhead of the Lua engine
+    _chunk_inputs.clear();
+    for (const auto& values : _chunk_values)
+    {
+      _chunk_inputs.push_back(values.data());
+    }
+    _chunk_output.resize(count);
+    _native_expression->evaluate(_chunk_inputs, count, _chunk_output.data());
+    for (size_t i = 0; i < count; i++)
+    {
+      points.emplace_back(time[i], _chunk_output[i]);
+    }
+    return;
+  }
+
+  std::vector<sol::table> arguments;
+  arguments.reserve(_chunk_values.size());
+  for (const auto& values : _chunk_values)
+  {
+    sol::table table = _lua_engine.create_table(int(values.size()), 0);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+      table.raw_set(i + 1, values[i]);
+    }
+    arguments.push_back(table);
+  }
+
+  sol::safe_function_result result = _lua_function(sol::as_args(arguments));
+
+  if (!result.valid())
+  {
+    sol::error err = result;
+    throw std::runtime_error(getError(err));
+  }
+
+  if (result.return_count() == 1 && result.get_type(0) == sol::type::table)
+  {
+    auto out_values = result.get<std::vector<double>>(0);
+    if (out_values.size() != count)
+    {
+      throw std::runtime_error("Wrong return object: the array of values must have the "
+                               "same size of the array time");
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+      points.emplace_back(time[i], out_values[i]);
+    }
+  }
+  else if (result.return_count() == 2 && result.get_type(0) == sol::type::table &&
+           result.get_type(1) == sol::type::table)
+  {
+    auto out_time = result.get<std::vector<double>>(0);
+    auto out_values = result.get<std::vector<double>>(1);
+    if (out_values.size() != out_time.size())
+    {
+      throw std::runtime_error("Wrong return object: the arrays of time and values "
+                               "must have the same size");
+    }
+    for (size_t i = 0; i < out_time.size(); i++)
+    {
+      points.emplace_back(out_time[i], out_values[i]);
+    }
+  }
+  else
+  {
+    throw std::runtime_error("Wrong return object: in vectorized mode, expecting either "
+                             "an array of values or two arrays (time, value)");
+  }
+}
+
+void LuaCustomFunction::alignChunk(const std::vector<const PlotData*>& src_data,
+                                   size_t first_index, size_t last_index)
+{
+  const PlotData* main_data = src_data.front();
+  const size_t count = last_index - first_index;
+
+  // _chunk_values[0] is the time, then value, v1, v2, etc.
+  _chunk_values.resize(src_data.size() + 1);
+  for (auto& values : _chunk_values)
+  {
+    values.resize(count);
+  }
+
+  for (size_t i = 0; i < count; i++)
+  {
+    const auto& p = main_data->at(first_index + i);
+    _chunk_values[0][i] = p.x;
+    _chunk_values[1][i] = p.y;
+  }
+
+  // align the additional sources to the time of the main one (nearest sample)
+  _aligner.setSeries(src_data);
+  const auto& time = _chunk_values[0];
+  for (size_t chan_index = 1; chan_index < src_data.size(); chan_index++)
+  {
+    _aligner.sample(chan_index, time.data(), count, _chunk_values[chan_index + 1].data());
+  }
+}
+
 bool LuaCustomFunction::xmlLoadState(const QDomElement& parent_element)
 {
   bool ret = CustomFunction::xmlLoadState(parent_element);
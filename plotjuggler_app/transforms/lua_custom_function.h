@@ -2,6 +2,7 @@
 #define LUA_CUSTOM_FUNCTION_H
 
 #include "custom_function.h"
+#include "native_expression.h"
 #include "sol.hpp"
 
 class LuaCustomFunction : public CustomFunction
@@ -14,6 +15,9 @@ public:
   void calculatePoints(const std::vector<const PlotData*>& channels_data,
                        size_t point_index, std::vector<PlotData::Point>& points) override;
 
+  void calculateChunk(const std::vector<const PlotData*>& src_data, size_t first_index,
+                      size_t last_index, std::vector<PlotData::Point>& points) override;
+
   QString language() const override
   {
     return "LUA";
@@ -26,12 +30,27 @@ public:
 
   bool xmlLoadState(const QDomElement& parent_element) override;
 
+  // each instance owns its own Lua engine
+  bool isThreadSafe() const override
+  {
+    return true;
+  }
+
   std::string getError(sol::error err);
 
 private:
+  // fill _chunk_values with the time and the values of each source,
+  // aligned to the points [first_index, last_index) of the main source.
+  void alignChunk(const std::vector<const PlotData*>& src_data, size_t first_index,
+                  size_t last_index);
+
   sol::state _lua_engine;
   sol::protected_function _lua_function;
   std::vector<double> _chan_values;
+  std::vector<std::vector<double>> _chunk_values;
+  std::vector<const double*> _chunk_inputs;
+  std::vector<double> _chunk_output;
+  std::unique_ptr<NativeExpression> _native_expression;
   std::mutex mutex_;
   int global_lines_ = 0;
   int function_lines_ = 0;
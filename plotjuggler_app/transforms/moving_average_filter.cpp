@@ -6,16 +6,21 @@
 MovingAverageFilter::MovingAverageFilter()
   : ui(new Ui::MovingAverageFilter)
   , _widget(new QWidget())
-  , _buffer(1)
-  , _ring_view(_buffer.begin(), _buffer.end())
 {
   ui->setupUi(_widget);
+  _samples_count = ui->spinBoxSamples->value();
+  _compensate_offset = ui->checkBoxTimeOffset->isChecked();
 
   connect(ui->spinBoxSamples, qOverload<int>(&QSpinBox::valueChanged), this,
-          [=](int) { emit parametersChanged(); });
+          [=](int value) {
+            _samples_count = value;
+            emit parametersChanged();
+          });
 
-  connect(ui->checkBoxTimeOffset, &QCheckBox::toggled, this,
-          [=]() { emit parametersChanged(); });
+  connect(ui->checkBoxTimeOffset, &QCheckBox::toggled, this, [=](bool checked) {
+    _compensate_offset = checked;
+    emit parametersChanged();
+  });
 }
 
 MovingAverageFilter::~MovingAverageFilter()
@@ -26,42 +31,34 @@ MovingAverageFilter::~MovingAverageFilter()
 
 void MovingAverageFilter::reset()
 {
-  _buffer.clear();
+  _window.clear();
   TransformFunction_SISO::reset();
 }
 
 std::optional<PlotData::Point> MovingAverageFilter::calculateNextPoint(size_t index)
 {
-  size_t buffer_size =
-      std::min(size_t(ui->spinBoxSamples->value()), size_t(dataSource()->size()));
-  if (buffer_size != _buffer.size())
+  size_t buffer_size = std::min(size_t(_samples_count), size_t(dataSource()->size()));
+  if (buffer_size != _window.sampleCount())
   {
-    _buffer.resize(buffer_size);
-    _ring_view = nonstd::ring_span<PlotData::Point>(_buffer.begin(), _buffer.end());
+    _window.setSampleCount(buffer_size);
   }
 
   const auto& p = dataSource()->at(index);
-  _ring_view.push_back(p);
 
-  while (_ring_view.size() < buffer_size)
+  // the first sample fills the whole window
+  while (_window.size() + 1 < buffer_size)
   {
-    _ring_view.push_back(p);
-  }
-
-  double total = 0;
-
-  for (size_t i = 0; i < buffer_size; i++)
-  {
-    total += _ring_view[i].y;
+    _window.push(p.x, p.y);
   }
+  _window.push(p.x, p.y);
 
   double time = p.x;
-  if (ui->checkBoxTimeOffset->isChecked())
+  if (_compensate_offset)
   {
-    time = (_ring_view.back().x + _ring_view.front().x) / 2.0;
+    time = (_window.backTime() + _window.frontTime()) / 2.0;
   }
 
-  PlotData::Point out = { time, total / _ring_view.size() };
+  PlotData::Point out = { time, _window.mean() };
   return out;
 }
 
@@ -5,7 +5,7 @@
 #include <QDoubleSpinBox>
 #include "PlotJuggler/transform_function.h"
 #include "ui_moving_average_filter.h"
-#include "PlotJuggler/ring_span.hpp"
+#include "PlotJuggler/util/sliding_window.hpp"
 
 using namespace PJ;
 
@@ -28,6 +28,11 @@ public:
     return "Moving Average";
   }
 
+  bool isThreadSafe() const override
+  {
+    return true;
+  }
+
   QWidget* optionsWidget() override;
 
   bool xmlSaveState(QDomDocument& doc, QDomElement& parent_element) const override;
@@ -37,8 +42,9 @@ public:
 private:
   Ui::MovingAverageFilter* ui;
   QWidget* _widget;
-  std::vector<PlotData::Point> _buffer;
-  nonstd::ring_span_lite::ring_span<PlotData::Point> _ring_view;
+  SlidingWindow _window;
+  int _samples_count;
+  bool _compensate_offset;
 
   std::optional<PlotData::Point> calculateNextPoint(size_t index) override;
 };
@@ -4,13 +4,15 @@
 MovingRMS::MovingRMS()
   : ui(new Ui::MovingRMS)
   , _widget(new QWidget())
-  , _buffer(1)
-  , _ring_view(_buffer.begin(), _buffer.end())
 {
   ui->setupUi(_widget);
+  _samples_count = ui->spinBoxSamples->value();
 
   connect(ui->spinBoxSamples, qOverload<int>(&QSpinBox::valueChanged), this,
-          [=](int) { emit parametersChanged(); });
+          [=](int value) {
+            _samples_count = value;
+            emit parametersChanged();
+          });
 }
 
 MovingRMS::~MovingRMS()
@@ -21,7 +23,7 @@ MovingRMS::~MovingRMS()
 
 void MovingRMS::reset()
 {
-  _buffer.clear();
+  _window.clear();
   TransformFunction_SISO::reset();
 }
 
@@ -47,32 +49,21 @@ bool MovingRMS::xmlLoadState(const QDomElement& parent_element)
 
 std::optional<PJ::PlotData::Point> MovingRMS::calculateNextPoint(size_t index)
 {
-  size_t buffer_size =
-      std::min(size_t(ui->spinBoxSamples->value()), size_t(dataSource()->size()));
-  if (buffer_size != _buffer.size())
+  size_t buffer_size = std::min(size_t(_samples_count), size_t(dataSource()->size()));
+  if (buffer_size != _window.sampleCount())
   {
-    _buffer.resize(buffer_size);
-    _ring_view = nonstd::ring_span<PJ::PlotData::Point>(_buffer.begin(), _buffer.end());
+    _window.setSampleCount(buffer_size);
   }
 
   const auto& p = dataSource()->at(index);
-  _ring_view.push_back(p);
 
-  while (_ring_view.size() < buffer_size)
+  // the first sample fills the whole window
+  while (_window.size() + 1 < buffer_size)
   {
-    _ring_view.push_back(p);
+    _window.push(p.x, p.y);
   }
+  _window.push(p.x, p.y);
 
-  double total_sqr = 0;
-
-  for (size_t i = 0; i < buffer_size; i++)
-  {
-    double val = _ring_view[i].y;
-    total_sqr += val * val;
-  }
-
-  double time = p.x;
-
-  PJ::PlotData::Point out = { time, sqrt(total_sqr / _ring_view.size()) };
+  PJ::PlotData::Point out = { p.x, _window.rms() };
   return out;
 }
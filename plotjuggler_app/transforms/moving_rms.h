@@ -4,7 +4,7 @@
 #include <QSpinBox>
 #include <QWidget>
 #include "PlotJuggler/transform_function.h"
-#include "PlotJuggler/ring_span.hpp"
+#include "PlotJuggler/util/sliding_window.hpp"
 
 namespace Ui
 {
@@ -27,6 +27,11 @@ public:
     return "Moving Root Mean Squared";
   }
 
+  bool isThreadSafe() const override
+  {
+    return true;
+  }
+
   QWidget* optionsWidget() override;
 
   bool xmlSaveState(QDomDocument& doc, QDomElement& parent_element) const override;
@@ -37,8 +42,8 @@ private:
   Ui::MovingRMS* ui;
 
   QWidget* _widget;
-  std::vector<PJ::PlotData::Point> _buffer;
-  nonstd::ring_span_lite::ring_span<PJ::PlotData::Point> _ring_view;
+  PJ::SlidingWindow _window;
+  int _samples_count;
 
   std::optional<PJ::PlotData::Point> calculateNextPoint(size_t index) override;
 };
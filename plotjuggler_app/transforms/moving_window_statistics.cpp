@@ -0,0 +1,84 @@
+#include "moving_window_statistics.h"
+#include "ui_moving_window_statistics.h"
+
+MovingWindowStatistic::MovingWindowStatistic()
+  : ui(new Ui::MovingWindowStatistic), _widget(new QWidget())
+{
+  ui->setupUi(_widget);
+  updateWindowSize();
+
+  auto onChanged = [=]() {
+    updateWindowSize();
+    emit parametersChanged();
+  };
+
+  connect(ui->spinBoxSamples, qOverload<int>(&QSpinBox::valueChanged), this, onChanged);
+  connect(ui->spinBoxTime, qOverload<double>(&QDoubleSpinBox::valueChanged), this,
+          onChanged);
+  connect(ui->radioSamples, &QRadioButton::toggled, this, onChanged);
+}
+
+MovingWindowStatistic::~MovingWindowStatistic()
+{
+  delete ui;
+  delete _widget;
+}
+
+void MovingWindowStatistic::reset()
+{
+  _window.clear();
+  TransformFunction_SISO::reset();
+}
+
+QWidget* MovingWindowStatistic::optionsWidget()
+{
+  return _widget;
+}
+
+bool MovingWindowStatistic::xmlSaveState(QDomDocument& doc,
+                                         QDomElement& parent_element) const
+{
+  QDomElement widget_el = doc.createElement("options");
+  widget_el.setAttribute("mode", ui->radioSamples->isChecked() ? "samples" : "time");
+  widget_el.setAttribute("value", ui->spinBoxSamples->value());
+  widget_el.setAttribute("time_span", ui->spinBoxTime->value());
+  parent_element.appendChild(widget_el);
+  return true;
+}
+
+bool MovingWindowStatistic::xmlLoadState(const QDomElement& parent_element)
+{
+  QDomElement widget_el = parent_element.firstChildElement("options");
+  ui->spinBoxSamples->setValue(widget_el.attribute("value", "10").toInt());
+  ui->spinBoxTime->setValue(widget_el.attribute("time_span", "1.0").toDouble());
+  if (widget_el.attribute("mode") == "time")
+  {
+    ui->radioTime->setChecked(true);
+  }
+  else
+  {
+    ui->radioSamples->setChecked(true);
+  }
+  return true;
+}
+
+void MovingWindowStatistic::updateWindowSize()
+{
+  if (ui->radioSamples->isChecked())
+  {
+    _window.setSampleCount(size_t(ui->spinBoxSamples->value()));
+  }
+  else
+  {
+    _window.setTimeSpan(ui->spinBoxTime->value());
+  }
+}
+
+std::optional<PJ::PlotData::Point> MovingWindowStatistic::calculateNextPoint(size_t index)
+{
+  const auto& p = dataSource()->at(index);
+  _window.push(p.x, p.y);
+
+  PJ::PlotData::Point out = { p.x, aggregate(_window) };
+  return out;
+}
@@ -0,0 +1,93 @@
+#ifndef MOVING_WINDOW_STATISTICS_H
+#define MOVING_WINDOW_STATISTICS_H
+
+#include <QWidget>
+#include "PlotJuggler/transform_function.h"
+#include "PlotJuggler/util/sliding_window.hpp"
+
+namespace Ui
+{
+class MovingWindowStatistic;
+}
+
+/// Common base of the transforms that compute a statistic over a sliding window,
+/// bounded either by number of samples or by time span.
+class MovingWindowStatistic : public PJ::TransformFunction_SISO
+{
+public:
+  explicit MovingWindowStatistic();
+
+  ~MovingWindowStatistic() override;
+
+  void reset() override;
+
+  bool isThreadSafe() const override
+  {
+    return true;
+  }
+
+  QWidget* optionsWidget() override;
+
+  bool xmlSaveState(QDomDocument& doc, QDomElement& parent_element) const override;
+
+  bool xmlLoadState(const QDomElement& parent_element) override;
+
+protected:
+  virtual double aggregate(const PJ::SlidingWindow& window) const = 0;
+
+private:
+  Ui::MovingWindowStatistic* ui;
+  QWidget* _widget;
+  PJ::SlidingWindow _window;
+
+  void updateWindowSize();
+
+  std::optional<PJ::PlotData::Point> calculateNextPoint(size_t index) override;
+};
+
+class MovingMinimum : public MovingWindowStatistic
+{
+public:
+  const char* name() const override
+  {
+    return "Moving Minimum";
+  }
+
+protected:
+  double aggregate(const PJ::SlidingWindow& window) const override
+  {
+    return window.min();
+  }
+};
+
+class MovingMaximum : public MovingWindowStatistic
+{
+public:
+  const char* name() const override
+  {
+    return "Moving Maximum";
+  }
+
+protected:
+  double aggregate(const PJ::SlidingWindow& window) const override
+  {
+    return window.max();
+  }
+};
+
+class MovingStandardDeviation : public MovingWindowStatistic
+{
+public:
+  const char* name() const override
+  {
+    return "Moving Standard Deviation";
+  }
+
+protected:
+  double aggregate(const PJ::SlidingWindow& window) const override
+  {
+    return window.stddev();
+  }
+};
+
+#endif  // MOVING_WINDOW_STATISTICS_H
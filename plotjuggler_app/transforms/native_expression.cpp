@@ -0,0 +1,648 @@
+#include "native_expression.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+struct NativeExpression::Node
+{
+  enum Type
+  {
+    CONSTANT,
+    INPUT,
+    NEGATE,
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    MOD,
+    POW,
+    CALL
+  };
+
+  enum Function
+  {
+    ABS,
+    SQRT,
+    SIN,
+    COS,
+    TAN,
+    ASIN,
+    ACOS,
+    ATAN,
+    EXP,
+    LOG,
+    FLOOR,
+    CEIL,
+    FMOD,
+    MIN,
+    MAX
+  };
+
+  Type type = CONSTANT;
+  double value = 0;
+  size_t input = 0;
+  Function function = ABS;
+  std::vector<std::unique_ptr<Node>> children;
+};
+
+namespace
+{
+using Node = NativeExpression::Node;
+
+// thrown when the code is not supported
+struct Unsupported
+{
+};
+
+struct Token
+{
+  enum Type
+  {
+    NUMBER,
+    NAME,
+    SYMBOL,
+    END
+  };
+  Type type;
+  std::string text;
+  double number = 0;
+};
+
+std::vector<Token> Tokenize(const std::string& code)
+{
+  std::vector<Token> tokens;
+  size_t pos = 0;
+  while (pos < code.size())
+  {
+    const char c = code[pos];
+    if (std::isspace(static_cast<unsigned char>(c)))
+    {
+      pos++;
+    }
+    else if (c == '-' && pos + 1 < code.size() && code[pos + 1] == '-')
+    {
+      // comment until the end of the line. Block comments are not supported
+      if (code.compare(pos, 3, "--[") == 0)
+      {
+        throw Unsupported();
+      }
+      pos = code.find('\n', pos);
+      if (pos == std::string::npos)
+      {
+        pos = code.size();
+      }
+    }
+    else if (std::isdigit(static_cast<unsigned char>(c)) ||
+             (c == '.' && pos + 1 < code.size() &&
+              std::isdigit(static_cast<unsigned char>(code[pos + 1]))))
+    {
+      if (code.compare(pos, 2, "0x") == 0 || code.compare(pos, 2, "0X") == 0)
+      {
+        throw Unsupported();
+      }
+      const char* start = code.c_str() + pos;
+      char* end = nullptr;
+      Token token{ Token::NUMBER, {}, std::strtod(start, &end) };
+      token.text.assign(start, static_cast<size_t>(end - start));
+      pos += (end - start);
+      // something like "12abc" is not a valid Lua number
+      if (pos < code.size() &&
+          (std::isalnum(static_cast<unsigned char>(code[pos])) || code[pos] == '_'))
+      {
+        throw Unsupported();
+      }
+      tokens.push_back(token);
+    }
+    else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+    {
+      size_t end = pos;
+      while (end < code.size() &&
+             (std::isalnum(static_cast<unsigned char>(code[end])) || code[end] == '_' ||
+              code[end] == '.'))
+      {
+        end++;
+      }
+      tokens.push_back({ Token::NAME, code.substr(pos, end - pos) });
+      pos = end;
+    }
+    else if (std::string("+-*/%^(),;").find(c) != std::string::npos)
+    {
+      tokens.push_back({ Token::SYMBOL, std::string(1, c) });
+      pos++;
+    }
+    else
+    {
+      throw Unsupported();
+    }
+  }
+  tokens.push_back({ Token::END, {} });
+  return tokens;
+}
+
+class Parser
+{
+public:
+  Parser(std::vector<Token> tokens, int additional_sources)
+    : _tokens(std::move(tokens)), _additional_sources(additional_sources)
+  {
+  }
+
+  std::unique_ptr<Node> parseFunctionBody()
+  {
+    if (!accept(Token::NAME, "return"))
+    {
+      throw Unsupported();
+    }
+    auto root = parseAdditive();
+    accept(Token::SYMBOL, ";");
+    if (peek().type != Token::END)
+    {
+      throw Unsupported();
+    }
+    return root;
+  }
+
+private:
+  std::vector<Token> _tokens;
+  int _additional_sources;
+  size_t _pos = 0;
+
+  const Token& peek() const
+  {
+    return _tokens[_pos];
+  }
+
+  bool accept(Token::Type type, const char* text)
+  {
+    if (peek().type == type && peek().text == text)
+    {
+      _pos++;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(const char* symbol)
+  {
+    if (!accept(Token::SYMBOL, symbol))
+    {
+      throw Unsupported();
+    }
+  }
+
+  static std::unique_ptr<Node> makeNode(Node::Type type)
+  {
+    auto node = std::make_unique<Node>();
+    node->type = type;
+    return node;
+  }
+
+  static std::unique_ptr<Node> makeConstant(double value)
+  {
+    auto node = makeNode(Node::CONSTANT);
+    node->value = value;
+    return node;
+  }
+
+  static std::unique_ptr<Node> makeBinary(Node::Type type, std::unique_ptr<Node> lhs,
+                                          std::unique_ptr<Node> rhs)
+  {
+    auto node = makeNode(type);
+    node->children.push_back(std::move(lhs));
+    node->children.push_back(std::move(rhs));
+    return node;
+  }
+
+  std::unique_ptr<Node> parseAdditive()
+  {
+    auto node = parseMultiplicative();
+    while (true)
+    {
+      if (accept(Token::SYMBOL, "+"))
+      {
+        node = makeBinary(Node::ADD, std::move(node), parseMultiplicative());
+      }
+      else if (accept(Token::SYMBOL, "-"))
+      {
+        node = makeBinary(Node::SUB, std::move(node), parseMultiplicative());
+      }
+      else
+      {
+        return node;
+      }
+    }
+  }
+
+  std::unique_ptr<Node> parseMultiplicative()
+  {
+    auto node = parseUnary();
+    while (true)
+    {
+      if (accept(Token::SYMBOL, "*"))
+      {
+        node = makeBinary(Node::MUL, std::move(node), parseUnary());
+      }
+      else if (accept(Token::SYMBOL, "/"))
+      {
+        node = makeBinary(Node::DIV, std::move(node), parseUnary());
+      }
+      else if (accept(Token::SYMBOL, "%"))
+      {
+        node = makeBinary(Node::MOD, std::move(node), parseUnary());
+      }
+      else
+      {
+        return node;
+      }
+    }
+  }
+
+  // In Lua, the power operator has higher priority than the unary minus:
+  // -a^b is -(a^b), while a^-b is valid.
+  std::unique_ptr<Node> parseUnary()
+  {
+    if (accept(Token::SYMBOL, "-"))
+    {
+      auto node = makeNode(Node::NEGATE);
+      node->children.push_back(parseUnary());
+      return node;
+    }
+    return parsePower();
+  }
+
+  std::unique_ptr<Node> parsePower()
+  {
+    auto node = parsePrimary();
+    if (accept(Token::SYMBOL, "^"))
+    {
+      node = makeBinary(Node::POW, std::move(node), parseUnary());
+    }
+    return node;
+  }
+
+  std::unique_ptr<Node> parsePrimary()
+  {
+    const Token token = peek();
+    if (token.type == Token::NUMBER)
+    {
+      _pos++;
+      return makeConstant(token.number);
+    }
+    if (accept(Token::SYMBOL, "("))
+    {
+      auto node = parseAdditive();
+      expect(")");
+      return node;
+    }
+    if (token.type != Token::NAME)
+    {
+      throw Unsupported();
+    }
+    _pos++;
+
+    if (token.text == "math.pi")
+    {
+      return makeConstant(M_PI);
+    }
+    if (token.text == "math.huge")
+    {
+      return makeConstant(std::numeric_limits<double>::infinity());
+    }
+    if (token.text == "time")
+    {
+      return makeInput(0);
+    }
+    if (token.text == "value")
+    {
+      return makeInput(1);
+    }
+    if (token.text.size() > 1 && token.text[0] == 'v' &&
+        token.text.find_first_not_of("0123456789", 1) == std::string::npos &&
+        token.text[1] != '0')
+    {
+      int index = std::atoi(token.text.c_str() + 1);
+      if (index <= _additional_sources)
+      {
+        return makeInput(1 + index);
+      }
+    }
+    if (peek().type == Token::SYMBOL && peek().text == "(")
+    {
+      return parseCall(token.text);
+    }
+    throw Unsupported();
+  }
+
+  static std::unique_ptr<Node> makeInput(size_t index)
+  {
+    auto node = makeNode(Node::INPUT);
+    node->input = index;
+    return node;
+  }
+
+  std::unique_ptr<Node> parseCall(const std::string& name)
+  {
+    struct FunctionInfo
+    {
+      const char* name;
+      Node::Function function;
+      size_t min_args;
+      size_t max_args;
+    };
+    static const FunctionInfo functions[] = {
+      { "math.abs", Node::ABS, 1, 1 },        { "math.sqrt", Node::SQRT, 1, 1 },
+      { "math.sin", Node::SIN, 1, 1 },        { "math.cos", Node::COS, 1, 1 },
+      { "math.tan", Node::TAN, 1, 1 },        { "math.asin", Node::ASIN, 1, 1 },
+      { "math.acos", Node::ACOS, 1, 1 },      { "math.atan", Node::ATAN, 1, 2 },
+      { "math.exp", Node::EXP, 1, 1 },        { "math.log", Node::LOG, 1, 2 },
+      { "math.floor", Node::FLOOR, 1, 1 },    { "math.ceil", Node::CEIL, 1, 1 },
+      { "math.fmod", Node::FMOD, 2, 2 },      { "math.min", Node::MIN, 1, 64 },
+      { "math.max", Node::MAX, 1, 64 },
+    };
+
+    const FunctionInfo* info = nullptr;
+    for (const auto& func : functions)
+    {
+      if (name == func.name)
+      {
+        info = &func;
+      }
+    }
+    if (!info)
+    {
+      throw Unsupported();
+    }
+
+    auto node = makeNode(Node::CALL);
+    node->function = info->function;
+
+    expect("(");
+    if (!accept(Token::SYMBOL, ")"))
+    {
+      do
+      {
+        node->children.push_back(parseAdditive());
+      } while (accept(Token::SYMBOL, ","));
+      expect(")");
+    }
+
+    if (node->children.size() < info->min_args || node->children.size() > info->max_args)
+    {
+      throw Unsupported();
+    }
+    return node;
+  }
+};
+
+// Lua modulo: the result has the same sign of the divisor
+inline double LuaMod(double a, double b)
+{
+  double m = std::fmod(a, b);
+  if (m != 0 && (m < 0) != (b < 0))
+  {
+    m += b;
+  }
+  return m;
+}
+
+template <typename Op>
+void ApplyUnary(double* data, size_t count, Op op)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    data[i] = op(data[i]);
+  }
+}
+
+template <typename Op>
+void ApplyBinary(double* lhs, const double* rhs, size_t count, Op op)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    lhs[i] = op(lhs[i], rhs[i]);
+  }
+}
+
+template <typename Op>
+void ApplyBinaryConst(double* lhs, double rhs, size_t count, Op op)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    lhs[i] = op(lhs[i], rhs);
+  }
+}
+
+void Evaluate(const Node& node, const std::vector<const double*>& inputs, size_t count,
+              double* out);
+
+template <typename Op>
+void EvaluateBinary(const Node& node, const std::vector<const double*>& inputs,
+                    size_t count, double* out, Op op)
+{
+  Evaluate(*node.children[0], inputs, count, out);
+  const Node& rhs = *node.children[1];
+  if (rhs.type == Node::CONSTANT)
+  {
+    ApplyBinaryConst(out, rhs.value, count, op);
+  }
+  else if (rhs.type == Node::INPUT)
+  {
+    ApplyBinary(out, inputs[rhs.input], count, op);
+  }
+  else
+  {
+    std::vector<double> tmp(count);
+    Evaluate(rhs, inputs, count, tmp.data());
+    ApplyBinary(out, tmp.data(), count, op);
+  }
+}
+
+void EvaluateCall(const Node& node, const std::vector<const double*>& inputs,
+                  size_t count, double* out)
+{
+  Evaluate(*node.children[0], inputs, count, out);
+
+  std::vector<double> arg;
+  if (node.children.size() > 1)
+  {
+    arg.resize(count);
+  }
+
+  switch (node.function)
+  {
+    case Node::ABS:
+      ApplyUnary(out, count, [](double x) { return std::abs(x); });
+      return;
+    case Node::SQRT:
+      ApplyUnary(out, count, [](double x) { return std::sqrt(x); });
+      return;
+    case Node::SIN:
+      ApplyUnary(out, count, [](double x) { return std::sin(x); });
+      return;
+    case Node::COS:
+      ApplyUnary(out, count, [](double x) { return std::cos(x); });
+      return;
+    case Node::TAN:
+      ApplyUnary(out, count, [](double x) { return std::tan(x); });
+      return;
+    case Node::ASIN:
+      ApplyUnary(out, count, [](double x) { return std::asin(x); });
+      return;
+    case Node::ACOS:
+      ApplyUnary(out, count, [](double x) { return std::acos(x); });
+      return;
+    case Node::EXP:
+      ApplyUnary(out, count, [](double x) { return std::exp(x); });
+      return;
+    case Node::FLOOR:
+      ApplyUnary(out, count, [](double x) { return std::floor(x); });
+      return;
+    case Node::CEIL:
+      ApplyUnary(out, count, [](double x) { return std::ceil(x); });
+      return;
+    case Node::ATAN:
+      if (node.children.size() == 1)
+      {
+        ApplyUnary(out, count, [](double x) { return std::atan(x); });
+      }
+      else
+      {
+        Evaluate(*node.children[1], inputs, count, arg.data());
+        ApplyBinary(out, arg.data(), count,
+                    [](double y, double x) { return std::atan2(y, x); });
+      }
+      return;
+    case Node::LOG:
+      if (node.children.size() == 1)
+      {
+        ApplyUnary(out, count, [](double x) { return std::log(x); });
+      }
+      else
+      {
+        Evaluate(*node.children[1], inputs, count, arg.data());
+        ApplyBinary(out, arg.data(), count,
+                    [](double x, double base) { return std::log(x) / std::log(base); });
+      }
+      return;
+    case Node::FMOD:
+      Evaluate(*node.children[1], inputs, count, arg.data());
+      ApplyBinary(out, arg.data(), count,
+                  [](double a, double b) { return std::fmod(a, b); });
+      return;
+    case Node::MIN:
+    case Node::MAX:
+      for (size_t c = 1; c < node.children.size(); c++)
+      {
+        Evaluate(*node.children[c], inputs, count, arg.data());
+        if (node.function == Node::MIN)
+        {
+          ApplyBinary(out, arg.data(), count,
+                      [](double a, double b) { return (b < a) ? b : a; });
+        }
+        else
+        {
+          ApplyBinary(out, arg.data(), count,
+                      [](double a, double b) { return (b > a) ? b : a; });
+        }
+      }
+      return;
+  }
+}
+
+void Evaluate(const Node& node, const std::vector<const double*>& inputs, size_t count,
+              double* out)
+{
+  switch (node.type)
+  {
+    case Node::CONSTANT:
+      std::fill(out, out + count, node.value);
+      return;
+    case Node::INPUT:
+      std::copy(inputs[node.input], inputs[node.input] + count, out);
+      return;
+    case Node::NEGATE:
+      Evaluate(*node.children[0], inputs, count, out);
+      ApplyUnary(out, count, [](double x) { return -x; });
+      return;
+    case Node::ADD:
+      EvaluateBinary(node, inputs, count, out, [](double a, double b) { return a + b; });
+      return;
+    case Node::SUB:
+      EvaluateBinary(node, inputs, count, out, [](double a, double b) { return a - b; });
+      return;
+    case Node::MUL:
+      EvaluateBinary(node, inputs, count, out, [](double a, double b) { return a * b; });
+      return;
+    case Node::DIV:
+      EvaluateBinary(node, inputs, count, out, [](double a, double b) { return a / b; });
+      return;
+    case Node::MOD:
+      EvaluateBinary(node, inputs, count, out, LuaMod);
+      return;
+    case Node::POW:
+      if (node.children[1]->type == Node::CONSTANT && node.children[1]->value == 2.0)
+      {
+        Evaluate(*node.children[0], inputs, count, out);
+        ApplyUnary(out, count, [](double x) { return x * x; });
+      }
+      else
+      {
+        EvaluateBinary(node, inputs, count, out,
+                       [](double a, double b) { return std::pow(a, b); });
+      }
+      return;
+    case Node::CALL:
+      EvaluateCall(node, inputs, count, out);
+      return;
+  }
+}
+
+// Replace operations on constants with their result
+void FoldConstants(std::unique_ptr<Node>& node)
+{
+  bool all_constants = true;
+  for (auto& child : node->children)
+  {
+    FoldConstants(child);
+    all_constants &= (child->type == Node::CONSTANT);
+  }
+  if (node->children.empty() || !all_constants)
+  {
+    return;
+  }
+  double result = 0;
+  Evaluate(*node, {}, 1, &result);
+  node->children.clear();
+  node->type = Node::CONSTANT;
+  node->value = result;
+}
+
+}  // namespace
+
+std::unique_ptr<NativeExpression> NativeExpression::compile(const std::string& body,
+                                                            int additional_sources)
+{
+  try
+  {
+    Parser parser(Tokenize(body), additional_sources);
+    std::unique_ptr<NativeExpression> expression(new NativeExpression());
+    expression->_root = parser.parseFunctionBody();
+    FoldConstants(expression->_root);
+    return expression;
+  }
+  catch (Unsupported&)
+  {
+    return {};
+  }
+}
+
+NativeExpression::~NativeExpression() = default;
+
+void NativeExpression::evaluate(const std::vector<const double*>& inputs, size_t count,
+                                double* output) const
+{
+  Evaluate(*_root, inputs, count, output);
+}
@@ -0,0 +1,43 @@
+#ifndef NATIVE_EXPRESSION_H
+#define NATIVE_EXPRESSION_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Compiles a subset of Lua into a tree that is evaluated natively,
+ * one array of samples at a time.
+ *
+ * Supported functions have a body like "return <expression>", where the
+ * expression uses only numbers, the arguments (time, value, v1, v2, ...),
+ * the operators + - * / % ^, parenthesis and the most common math.*
+ * functions. Anything else must be executed by the Lua engine.
+ */
+class NativeExpression
+{
+public:
+  /// Return nullptr if the function body is not supported.
+  static std::unique_ptr<NativeExpression> compile(const std::string& function_body,
+                                                   int additional_sources);
+
+  ~NativeExpression();
+
+  /** Evaluate the expression on arrays of aligned samples.
+   *
+   * @param inputs  arrays of size count: time, value, v1, v2, etc.
+   * @param count   number of samples.
+   * @param output  array of size count where the result is written.
+   */
+  void evaluate(const std::vector<const double*>& inputs, size_t count,
+                double* output) const;
+
+  struct Node;
+
+private:
+  NativeExpression() = default;
+
+  std::unique_ptr<Node> _root;
+};
+
+#endif  // NATIVE_EXPRESSION_H
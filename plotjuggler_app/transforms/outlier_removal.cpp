@@ -40,6 +40,19 @@ bool OutlierRemovalFilter::xmlLoadState(const QDomElement& parent_element)
   return true;
 }
 
+bool OutlierRemovalFilter::isOutlier(double thresh) const
+{
+  double d1 = (_ring_view[1] - _ring_view[2]);
+  double d2 = (_ring_view[2] - _ring_view[3]);
+  if (d1 * d2 < 0)  // spike
+  {
+    double d0 = (_ring_view[0] - _ring_view[1]);
+    double jump = std::max(std::abs(d1), std::abs(d2));
+    return (jump / std::abs(d0) > thresh);
+  }
+  return false;
+}
+
 std::optional<PJ::PlotData::Point> OutlierRemovalFilter::calculateNextPoint(size_t index)
 {
   const auto& p = dataSource()->at(index);
@@ -49,19 +62,42 @@ std::optional<PJ::PlotData::Point> OutlierRemovalFilter::calculateNextPoint(size
   {
     return p;
   }
+  if (isOutlier(ui->spinBoxFactor->value()))
+  {
+    return {};
+  }
+  return dataSource()->at(index - 1);
+}
 
-  double d1 = (_ring_view[1] - _ring_view[2]);
-  double d2 = (_ring_view[2] - _ring_view[3]);
-  if (d1 * d2 < 0)  // spike
+void OutlierRemovalFilter::calculateBatch(size_t first_index,
+                                          const PlotData::Point* input, size_t count,
+                                          std::vector<PlotData::Point>& output)
+{
+  if (count == 0)
   {
-    double d0 = (_ring_view[0] - _ring_view[1]);
-    double thresh = ui->spinBoxFactor->value();
+    return;
+  }
+  // the first point of the block depends on the previous block
+  auto first_point = calculateNextPoint(first_index);
+  if (first_point)
+  {
+    output.push_back(first_point.value());
+  }
 
-    double jump = std::max(std::abs(d1), std::abs(d2));
-    if (jump / std::abs(d0) > thresh)
+  const double thresh = ui->spinBoxFactor->value();
+  output.reserve(output.size() + count - 1);
+
+  for (size_t i = 1; i < count; i++)
+  {
+    _ring_view.push_back(input[i].y);
+
+    if (first_index + i < 3)
     {
-      return {};
+      output.push_back(input[i]);
+    }
+    else if (!isOutlier(thresh))
+    {
+      output.push_back(input[i - 1]);
     }
   }
-  return dataSource()->at(index - 1);
 }
@@ -37,5 +37,10 @@ private:
   std::vector<double> _buffer;
   nonstd::ring_span_lite::ring_span<double> _ring_view;
 
+  bool isOutlier(double thresh) const;
+
   std::optional<PlotData::Point> calculateNextPoint(size_t index) override;
+
+  void calculateBatch(size_t first_index, const PlotData::Point* input, size_t count,
+                      std::vector<PlotData::Point>& output) override;
 };
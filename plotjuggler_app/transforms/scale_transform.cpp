@@ -73,3 +73,21 @@ std::optional<PlotData::Point> ScaleTransform::calculateNextPoint(size_t index)
   PlotData::Point out = { p.x + off_x, scale * p.y + off_y };
   return out;
 }
+
+void ScaleTransform::calculateBatch(size_t, const PlotData::Point* input, size_t count,
+                                    std::vector<PlotData::Point>& output)
+{
+  // parse the parameters once per block, not once per point
+  const double off_x = ui->lineEditTimeOffset->text().toDouble();
+  const double off_y = ui->lineEditValueOffset->text().toDouble();
+  const double scale = ui->lineEditValueScale->text().toDouble();
+
+  const size_t offset = output.size();
+  output.resize(offset + count);
+  PlotData::Point* out = output.data() + offset;
+  for (size_t i = 0; i < count; i++)
+  {
+    out[i].x = input[i].x + off_x;
+    out[i].y = scale * input[i].y + off_y;
+  }
+}
@@ -31,6 +31,9 @@ private:
   Ui::ScaleTransform* ui;
 
   std::optional<PlotData::Point> calculateNextPoint(size_t index) override;
+
+  void calculateBatch(size_t first_index, const PlotData::Point* input, size_t count,
+                      std::vector<PlotData::Point>& output) override;
 };
 
 #endif  // SCALE_TRANSFORM_H
@@ -0,0 +1,178 @@
+#include "transform_scheduler.h"
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <unordered_map>
+#include <QtConcurrent>
+#include "custom_function.h"
+
+namespace
+{
+// Execute func on each item, in the thread pool. Exceptions are rethrown
+// in the caller thread.
+template <typename T, typename Function>
+void ParallelForEach(std::vector<T>& items, Function func)
+{
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  QtConcurrent::blockingMap(items, [&](T& item) {
+    try
+    {
+      func(item);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error)
+      {
+        error = std::current_exception();
+      }
+    }
+  });
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+}  // namespace
+
+void TransformScheduler::calculate(std::vector<TransformFunction*> functions)
+{
+  std::sort(
+      functions.begin(), functions.end(),
+      [](TransformFunction* a, TransformFunction* b) { return a->order() < b->order(); });
+
+  const size_t N = functions.size();
+
+  // CustomFunctions resolve their sources lazily
+  for (auto function : functions)
+  {
+    if (auto custom = dynamic_cast<CustomFunction*>(function))
+    {
+      custom->updateDataSources();
+    }
+  }
+
+  std::unordered_map<const PlotData*, std::vector<size_t>> writers;
+  for (size_t i = 0; i < N; i++)
+  {
+    for (const PlotData* dst : functions[i]->dataDestinations())
+    {
+      writers[dst].push_back(i);
+    }
+  }
+
+  // Assign each function to a level, that will be executed after all
+  // the previous ones. Dependencies are:
+  //  - read after write: a source is written by a previous function.
+  //  - write after read: a destination is read by a previous function.
+  //  - write after write: a destination is written by a previous function.
+  std::vector<size_t> level(N, 0);
+  std::vector<std::vector<size_t>> readers_of(N);
+  size_t max_level = 0;
+
+  for (size_t i = 0; i < N; i++)
+  {
+    auto add_dependency = [&](size_t prev) {
+      level[i] = std::max(level[i], level[prev] + 1);
+    };
+
+    for (const PlotData* src : functions[i]->dataSources())
+    {
+      auto it = writers.find(src);
+      if (it == writers.end())
+      {
+        continue;
+      }
+      for (size_t w : it->second)
+      {
+        if (w < i)
+        {
+          add_dependency(w);
+        }
+        else if (w > i)
+        {
+          readers_of[w].push_back(i);
+        }
+      }
+    }
+    for (size_t reader : readers_of[i])
+    {
+      add_dependency(reader);
+    }
+    for (const PlotData* dst : functions[i]->dataDestinations())
+    {
+      for (size_t w : writers[dst])
+      {
+        if (w < i)
+        {
+          add_dependency(w);
+        }
+      }
+    }
+    max_level = std::max(max_level, level[i]);
+  }
+
+  std::vector<TransformFunction*> parallel;
+  for (size_t current_level = 0; current_level <= max_level; current_level++)
+  {
+    parallel.clear();
+    for (size_t i = 0; i < N; i++)
+    {
+      if (level[i] != current_level)
+      {
+        continue;
+      }
+      if (functions[i]->isThreadSafe())
+      {
+        parallel.push_back(functions[i]);
+      }
+      else
+      {
+        functions[i]->calculate();
+      }
+    }
+
+    if (parallel.size() == 1)
+    {
+      parallel.front()->calculate();
+    }
+    else if (parallel.size() > 1)
+    {
+      ParallelForEach(parallel,
+                      [](TransformFunction* function) { function->calculate(); });
+    }
+  }
+}
+
+void TransformScheduler::updateCaches(const std::vector<QwtSeriesWrapper*>& series,
+                                      bool reset_older_data)
+{
+  std::vector<QwtSeriesWrapper*> parallel;
+  for (auto item : series)
+  {
+    auto transformed = dynamic_cast<TransformedTimeseries*>(item);
+    if (transformed &&
+        (!transformed->transform() || transformed->transform()->isThreadSafe()))
+    {
+      parallel.push_back(item);
+    }
+    else
+    {
+      item->updateCache(reset_older_data);
+    }
+  }
+
+  if (parallel.size() == 1)
+  {
+    parallel.front()->updateCache(reset_older_data);
+  }
+  else if (parallel.size() > 1)
+  {
+    ParallelForEach(parallel, [reset_older_data](QwtSeriesWrapper* item) {
+      item->updateCache(reset_older_data);
+    });
+  }
+}
@@ -0,0 +1,26 @@
+#ifndef TRANSFORM_SCHEDULER_H
+#define TRANSFORM_SCHEDULER_H
+
+#include <vector>
+#include "PlotJuggler/transform_function.h"
+#include "timeseries_qwt.h"
+
+/**
+ * @brief Evaluates a set of transforms, running in parallel the ones that
+ * don't depend on each other.
+ *
+ * Dependencies are found comparing dataSources() and dataDestinations():
+ * the result is the same as calling calculate() on each function sorted by order().
+ * Functions that are not thread safe are executed in the caller's thread.
+ */
+class TransformScheduler
+{
+public:
+  static void calculate(std::vector<PJ::TransformFunction*> functions);
+
+  /// Call updateCache() of the series, in parallel when their transform allows it.
+  static void updateCaches(const std::vector<QwtSeriesWrapper*>& series,
+                           bool reset_older_data);
+};
+
+#endif  // TRANSFORM_SCHEDULER_H
@@ -0,0 +1,137 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "undo_history.h"
+#include <algorithm>
+
+UndoHistory::UndoHistory(size_t max_size) : _max_size(max_size)
+{
+}
+
+void UndoHistory::clear()
+{
+  _current.clear();
+  _undo_deltas.clear();
+  _redo_deltas.clear();
+}
+
+void UndoHistory::reset(const QDomDocument& state)
+{
+  clear();
+  _current = state.toByteArray(-1);
+}
+
+bool UndoHistory::push(const QDomDocument& state)
+{
+  QByteArray xml = state.toByteArray(-1);
+  if (xml == _current)
+  {
+    return false;
+  }
+  if (!_current.isEmpty())
+  {
+    while (_undo_deltas.size() >= _max_size)
+    {
+      _undo_deltas.pop_front();
+    }
+    _undo_deltas.push_back(makeDelta(xml, _current));
+  }
+  _redo_deltas.clear();
+  _current = std::move(xml);
+  return true;
+}
+
+std::optional<QDomDocument> UndoHistory::undo()
+{
+  if (_undo_deltas.empty())
+  {
+    return std::nullopt;
+  }
+  QByteArray previous = applyDelta(_current, _undo_deltas.back());
+  _undo_deltas.pop_back();
+
+  while (_redo_deltas.size() >= _max_size)
+  {
+    _redo_deltas.pop_back();
+  }
+  _redo_deltas.push_front(makeDelta(previous, _current));
+  _current = std::move(previous);
+  return toDocument(_current);
+}
+
+std::optional<QDomDocument> UndoHistory::redo()
+{
+  if (_redo_deltas.empty())
+  {
+    return std::nullopt;
+  }
+  QByteArray next = applyDelta(_current, _redo_deltas.front());
+  _redo_deltas.pop_front();
+
+  while (_undo_deltas.size() >= _max_size)
+  {
+    _undo_deltas.pop_front();
+  }
+  _undo_deltas.push_back(makeDelta(next, _current));
+  _current = std::move(next);
+  return toDocument(_current);
+}
+
+size_t UndoHistory::memoryUsage() const
+{
+  size_t bytes = _current.size();
+  for (const auto& deltas : { &_undo_deltas, &_redo_deltas })
+  {
+    for (const auto& delta : *deltas)
+    {
+      bytes += sizeof(Delta) + delta.middle.size();
+    }
+  }
+  return bytes;
+}
+
+UndoHistory::Delta UndoHistory::makeDelta(const QByteArray& from, const QByteArray& to)
+{
+  const int max_common = std::min(from.size(), to.size());
+  const char* a = from.constData();
+  const char* b = to.constData();
+
+  int prefix = 0;
+  while (prefix < max_common && a[prefix] == b[prefix])
+  {
+    prefix++;
+  }
+  // prefix and suffix must not overlap
+  int suffix = 0;
+  while (suffix < max_common - prefix &&
+         a[from.size() - 1 - suffix] == b[to.size() - 1 - suffix])
+  {
+    suffix++;
+  }
+
+  Delta delta;
+  delta.prefix = prefix;
+  delta.suffix = suffix;
+  delta.middle = to.mid(prefix, to.size() - prefix - suffix);
+  return delta;
+}
+
+QByteArray UndoHistory::applyDelta(const QByteArray& from, const Delta& delta)
+{
+  QByteArray out;
+  out.reserve(delta.prefix + delta.middle.size() + delta.suffix);
+  out.append(from.constData(), delta.prefix);
+  out.append(delta.middle);
+  out.append(from.constData() + from.size() - delta.suffix, delta.suffix);
+  return out;
+}
+
+QDomDocument UndoHistory::toDocument(const QByteArray& xml)
+{
+  QDomDocument document;
+  document.setContent(xml);
+  return document;
+}
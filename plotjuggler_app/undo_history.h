@@ -0,0 +1,80 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UNDO_HISTORY_H
+#define UNDO_HISTORY_H
+
+#include <deque>
+#include <optional>
+#include <QByteArray>
+#include <QDomDocument>
+
+/**
+ * @brief Undo/redo stack of layout states.
+ *
+ * Only the current state is stored in full, as serialized XML. Any other state
+ * is stored as the difference with its neighbour: a layout change (zoom,
+ * new curve, edited snippet) usually touches a small portion of the document,
+ * therefore each step costs a few hundreds of bytes instead of a full copy.
+ */
+class UndoHistory
+{
+public:
+  explicit UndoHistory(size_t max_size = 100);
+
+  void clear();
+
+  /// Drop the history and use this state as the initial one.
+  void reset(const QDomDocument& state);
+
+  /// Add a new state and clear the redo stack.
+  /// Returns false if the state is equal to the current one.
+  bool push(const QDomDocument& state);
+
+  bool canUndo() const
+  {
+    return !_undo_deltas.empty();
+  }
+
+  bool canRedo() const
+  {
+    return !_redo_deltas.empty();
+  }
+
+  /// Move to the previous state and return it.
+  std::optional<QDomDocument> undo();
+
+  /// Move to the next state and return it.
+  std::optional<QDomDocument> redo();
+
+  /// Bytes used by the history.
+  size_t memoryUsage() const;
+
+private:
+  // Turns a document into another one, replacing the bytes between
+  // the common prefix and the common suffix.
+  struct Delta
+  {
+    int prefix;
+    int suffix;
+    QByteArray middle;
+  };
+
+  static Delta makeDelta(const QByteArray& from, const QByteArray& to);
+
+  static QByteArray applyDelta(const QByteArray& from, const Delta& delta);
+
+  static QDomDocument toDocument(const QByteArray& xml);
+
+  size_t _max_size;
+  QByteArray _current;
+  // deltas from the current state to the previous ones (oldest first)
+  std::deque<Delta> _undo_deltas;
+  // deltas from the current state to the next ones (newest first)
+  std::deque<Delta> _redo_deltas;
+};
+
+#endif  // UNDO_HISTORY_H
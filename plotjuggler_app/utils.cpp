@@ -19,6 +19,11 @@ MoveDataRet MoveData(PlotDataMapRef& source, PlotDataMapRef& destination,
       auto& source_plot = it.second;
       const std::string& plot_name = source_plot.plotName();
 
+      using SeriesType = std::decay_t<decltype(source_plot)>;
+      constexpr bool is_timeseries = std::is_same_v<PlotData, SeriesType> ||
+                                     std::is_same_v<StringSeries, SeriesType> ||
+                                     std::is_same_v<PlotDataAny, SeriesType>;
+
       auto dest_plot_it = destination_series.find(ID);
       if (dest_plot_it == destination_series.end())
       {
@@ -76,11 +81,10 @@ MoveDataRet MoveData(PlotDataMapRef& source, PlotDataMapRef& destination,
       if (source_plot.size() > 0)
       {
         ret.data_pushed = true;
+        ret.updated_curves.push_back(ID);
       }
 
-      if constexpr (std::is_same_v<PlotData, decltype(source_plot)> ||
-                    std::is_same_v<StringSeries, decltype(source_plot)> ||
-                    std::is_same_v<PlotDataAny, decltype(source_plot)>)
+      if constexpr (is_timeseries)
       {
         double max_range_x = source_plot.maximumRangeX();
         destination_plot.setMaximumRangeX(max_range_x);
@@ -90,10 +94,19 @@ MoveDataRet MoveData(PlotDataMapRef& source, PlotDataMapRef& destination,
       {
         std::swap(destination_plot, source_plot);
       }
-      else {
-        for (size_t i = 0; i < source_plot.size(); i++)
+      else
+      {
+        if constexpr (std::is_same_v<PlotData, SeriesType>)
+        {
+          // sorting and trimming are checked once for the entire block
+          destination_plot.pushBack(source_plot.begin(), source_plot.end());
+        }
+        else
         {
-          destination_plot.pushBack(source_plot.at(i));
+          for (size_t i = 0; i < source_plot.size(); i++)
+          {
+            destination_plot.pushBack(source_plot.at(i));
+          }
         }
         source_plot.clear();
       }
@@ -44,6 +44,8 @@ private:
 struct MoveDataRet
 {
   std::vector<std::string> added_curves;
+  // series that received new points
+  std::vector<std::string> updated_curves;
   bool curves_updated = false;
   bool data_pushed = false;
 };
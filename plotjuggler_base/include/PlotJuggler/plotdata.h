@@ -7,6 +7,7 @@
 #ifndef PJ_PLOTDATA_H
 #define PJ_PLOTDATA_H
 
+#include <set>
 #include "plotdatabase.h"
 #include "timeseries.h"
 #include "stringseries.h"
@@ -30,8 +31,61 @@ using ScatterXYMap = std::unordered_map<std::string, PlotDataXY>;
 using AnySeriesMap = std::unordered_map<std::string, PlotDataAny>;
 using StringSeriesMap = std::unordered_map<std::string, StringSeries>;
 
-struct PlotDataMapRef
+/**
+ * @brief Time range covered by many timeseries, updated one series at a time.
+ *
+ * The first and last timestamps of each series are kept in ordered sets, therefore
+ * an update costs O(log N) and a query O(1). Series without points are ignored.
+ */
+class TimeBounds
+{
+public:
+  void update(const PlotData& series);
+
+  void remove(const PlotData& series);
+
+  void clear();
+
+  bool empty() const
+  {
+    return _entries.empty();
+  }
+
+  /// Undefined if empty().
+  Range range() const
+  {
+    return { *_fronts.begin(), *_backs.rbegin() };
+  }
+
+  /// Number of points of the longest series; 0 if empty().
+  size_t maxSize() const
+  {
+    return _sizes.empty() ? 0 : *_sizes.rbegin();
+  }
+
+private:
+  struct Entry
+  {
+    double front;
+    double back;
+    size_t size;
+  };
+  std::unordered_map<const PlotData*, Entry> _entries;
+  std::multiset<double> _fronts;
+  std::multiset<double> _backs;
+  std::multiset<size_t> _sizes;
+};
+
+struct PlotDataMapRef : private TimeseriesObserver<double>
 {
+  PlotDataMapRef() = default;
+
+  // the numeric series keep a pointer to this object
+  PlotDataMapRef(const PlotDataMapRef&) = delete;
+  PlotDataMapRef& operator=(const PlotDataMapRef&) = delete;
+
+  ~PlotDataMapRef() override;
+
   ScatterXYMap scatter_xy;
 
   /// Numerical timeseries
@@ -78,6 +132,42 @@ struct PlotDataMapRef
   void setMaximumRangeX(double range);
 
   bool erase(const std::string& name);
+
+  /**
+   * @brief Time range of all the numeric series.
+   * The numeric series created by this object report their changes, therefore
+   * only the series changed since the previous query are read again.
+   */
+  const TimeBounds& timeBounds() const
+  {
+    updateChangedTimeBounds();
+    return _time_bounds;
+  }
+
+  /// Choose the numeric series considered by selectionTimeBounds().
+  void setTimeBoundsSelection(std::unordered_set<std::string> names);
+
+  const TimeBounds& selectionTimeBounds() const
+  {
+    updateChangedTimeBounds();
+    return _selection_time_bounds;
+  }
+
+private:
+  mutable TimeBounds _time_bounds;
+
+  std::unordered_set<std::string> _selection;
+  std::unordered_set<const PlotData*> _selected_series;
+  mutable TimeBounds _selection_time_bounds;
+
+  // series changed since the last update of the time bounds
+  mutable std::vector<PlotData*> _changed_series;
+
+  void updateChangedTimeBounds() const;
+
+  void onPointsChanged(PlotData* series) override;
+
+  void onDestroyed(PlotData* series) override;
 };
 
 template <typename Value>
@@ -7,6 +7,7 @@
 #ifndef PJ_PLOTDATA_BASE_H
 #define PJ_PLOTDATA_BASE_H
 
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <string>
@@ -34,6 +35,90 @@ struct Range
 
 typedef std::optional<Range> RangeOpt;
 
+/**
+ * @brief Count, extremes, mean and variance of a sequence of values.
+ * Summaries can be merged, therefore they can be computed in blocks.
+ */
+struct ValueSummary
+{
+  size_t count = 0;
+  double min = 0;
+  double max = 0;
+  // Sums of (value - shift), where shift is the first value. This keeps the
+  // variance accurate when the values have a large offset.
+  double shift = 0;
+  double sum = 0;
+  double sum_sq = 0;
+
+  void add(double value)
+  {
+    if (count == 0)
+    {
+      shift = value;
+      min = value;
+      max = value;
+    }
+    else
+    {
+      min = std::min(min, value);
+      max = std::max(max, value);
+    }
+    const double d = value - shift;
+    sum += d;
+    sum_sq += d * d;
+    count++;
+  }
+
+  void merge(const ValueSummary& other)
+  {
+    if (other.count == 0)
+    {
+      return;
+    }
+    if (count == 0)
+    {
+      *this = other;
+      return;
+    }
+    // express the sums of "other" relative to our shift
+    const double k = other.shift - shift;
+    const double n = double(other.count);
+    sum_sq += other.sum_sq + 2.0 * k * other.sum + k * k * n;
+    sum += other.sum + k * n;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    count += other.count;
+  }
+
+  double mean() const
+  {
+    return (count == 0) ? 0.0 : shift + sum / double(count);
+  }
+
+  /// Population variance.
+  double variance() const
+  {
+    if (count == 0)
+    {
+      return 0.0;
+    }
+    const double n = double(count);
+    return std::max(0.0, (sum_sq - sum * sum / n) / n);
+  }
+
+  double stdDev() const
+  {
+    return std::sqrt(variance());
+  }
+
+  /// Root mean square.
+  double rms() const
+  {
+    const double m = mean();
+    return std::sqrt(m * m + variance());
+  }
+};
+
 // Attributes supported by the GUI.
 enum PlotAttribute
 {
@@ -135,7 +220,9 @@ public:
   enum
   {
     MAX_CAPACITY = 1024 * 1024,
-    ASYNC_BUFFER_CAPACITY = 1024
+    ASYNC_BUFFER_CAPACITY = 1024,
+    // number of points summarized by each element of _chunk_summary
+    RANGE_CHUNK_SIZE = 1024
   };
 
   typedef typename std::deque<Point>::iterator Iterator;
@@ -160,6 +247,10 @@ public:
     _range_y = other._range_y;
     _range_x_dirty = other._range_x_dirty;
     _range_y_dirty = other._range_y_dirty;
+    _chunk_summary = other._chunk_summary;
+    _chunk_offset = other._chunk_offset;
+    _chunks_valid = other._chunks_valid;
+    _first_chunk_dirty = other._first_chunk_dirty;
   }
 
   virtual ~PlotDataBase() = default;
@@ -214,6 +305,7 @@ public:
     _points.clear();
     _range_x_dirty = true;
     _range_y_dirty = true;
+    resetChunks();
   }
 
   const Attributes& attributes() const
@@ -307,12 +399,28 @@ public:
       }
       if (_range_y_dirty)
       {
-        _range_y.min = front().y;
-        _range_y.max = _range_y.min;
-        for (const auto& p : _points)
+        if (!_chunks_valid)
         {
-          _range_y.min = std::min(_range_y.min, p.y);
-          _range_y.max = std::max(_range_y.max, p.y);
+          rebuildChunks();
+        }
+        else if (_first_chunk_dirty)
+        {
+          // only the oldest chunk lost some points
+          const size_t count =
+              std::min<size_t>(RANGE_CHUNK_SIZE - _chunk_offset, _points.size());
+          ValueSummary& summary = _chunk_summary.front();
+          summary = {};
+          for (size_t i = 0; i < count; i++)
+          {
+            summary.add(_points[i].y);
+          }
+          _first_chunk_dirty = false;
+        }
+        _range_y = { _chunk_summary.front().min, _chunk_summary.front().max };
+        for (const auto& summary : _chunk_summary)
+        {
+          _range_y.min = std::min(_range_y.min, summary.min);
+          _range_y.max = std::max(_range_y.max, summary.max);
         }
         _range_y_dirty = false;
       }
@@ -321,6 +429,53 @@ public:
     return std::nullopt;
   }
 
+  /**
+   * @brief Statistics of Y of the points with index in [first, last].
+   * Only the blocks of RANGE_CHUNK_SIZE points at the ends of the interval are
+   * scanned, the ones in the middle use their summary.
+   */
+  ValueSummary summaryY(size_t first, size_t last) const
+  {
+    ValueSummary summary;
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      if (_points.empty() || first > last || first >= _points.size())
+      {
+        return summary;
+      }
+      last = std::min(last, _points.size() - 1);
+      if (!_chunks_valid)
+      {
+        rebuildChunks();
+      }
+      size_t i = first;
+      while (i <= last)
+      {
+        // indexes of the points in the same chunk of "i": [chunk_begin, chunk_end)
+        const size_t chunk = (i + _chunk_offset) / RANGE_CHUNK_SIZE;
+        const size_t chunk_begin =
+            (chunk == 0) ? 0 : chunk * RANGE_CHUNK_SIZE - _chunk_offset;
+        const size_t chunk_end = (chunk + 1) * RANGE_CHUNK_SIZE - _chunk_offset;
+        const bool stale = (chunk == 0 && _first_chunk_dirty);
+
+        if (i == chunk_begin && chunk_end <= last + 1 && !stale)
+        {
+          summary.merge(_chunk_summary[chunk]);
+          i = chunk_end;
+        }
+        else
+        {
+          const size_t end = std::min(chunk_end, last + 1);
+          for (; i < end; i++)
+          {
+            summary.add(_points[i].y);
+          }
+        }
+      }
+    }
+    return summary;
+  }
+
   virtual void pushBack(const Point& p)
   {
     auto temp = p;
@@ -347,6 +502,19 @@ public:
     }
 
     _points.emplace_back(p);
+
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      if (_chunks_valid)
+      {
+        const size_t index = _chunk_offset + _points.size() - 1;
+        if (index % RANGE_CHUNK_SIZE == 0)
+        {
+          _chunk_summary.emplace_back();
+        }
+        _chunk_summary.back().add(p.y);
+      }
+    }
   }
 
   virtual void insert(Iterator it, Point&& p)
@@ -369,6 +537,8 @@ public:
     }
 
     _points.insert(it, p);
+    // the points after "it" moved to a different chunk
+    _chunks_valid = false;
   }
 
   virtual void popFront()
@@ -391,6 +561,26 @@ public:
       }
     }
     _points.pop_front();
+    dropChunkPoints(1);
+  }
+
+  /// Remove the first "count" points, at once.
+  virtual void popFront(size_t count)
+  {
+    if (count >= _points.size())
+    {
+      clear();
+      return;
+    }
+    if (count == 0)
+    {
+      return;
+    }
+    _points.erase(_points.begin(), _points.begin() + count);
+    // the summaries of the chunks make the update of the range cheap
+    _range_x_dirty = true;
+    _range_y_dirty = true;
+    dropChunkPoints(count);
   }
 
 protected:
@@ -404,6 +594,66 @@ protected:
   mutable bool _range_y_dirty;
   mutable std::shared_ptr<PlotGroup> _group;
 
+  // Summary of Y of consecutive blocks of RANGE_CHUNK_SIZE points. When the oldest
+  // points are removed, only the first block needs to be scanned again.
+  mutable std::deque<ValueSummary> _chunk_summary;
+  // number of points already removed from the first block
+  mutable size_t _chunk_offset = 0;
+  mutable bool _chunks_valid = true;
+  mutable bool _first_chunk_dirty = false;
+
+  void resetChunks()
+  {
+    _chunk_summary.clear();
+    _chunk_offset = 0;
+    _chunks_valid = true;
+    _first_chunk_dirty = false;
+  }
+
+  void rebuildChunks() const
+  {
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      _chunk_summary.clear();
+      for (size_t i = 0; i < _points.size(); i++)
+      {
+        if (i % RANGE_CHUNK_SIZE == 0)
+        {
+          _chunk_summary.emplace_back();
+        }
+        _chunk_summary.back().add(_points[i].y);
+      }
+      _chunk_offset = 0;
+      _chunks_valid = true;
+      _first_chunk_dirty = false;
+    }
+  }
+
+  // the first "count" points were removed
+  void dropChunkPoints(size_t count)
+  {
+    if (_points.empty())
+    {
+      resetChunks();
+      return;
+    }
+    if (!_chunks_valid || _chunk_summary.empty())
+    {
+      _chunks_valid = false;
+      return;
+    }
+    const size_t dropped = _chunk_offset + count;
+    const size_t dropped_chunks =
+        std::min<size_t>(dropped / RANGE_CHUNK_SIZE, _chunk_summary.size());
+    _chunk_summary.erase(_chunk_summary.begin(),
+                         _chunk_summary.begin() + dropped_chunks);
+    _chunk_offset = dropped % RANGE_CHUNK_SIZE;
+    if (_chunk_offset > 0)
+    {
+      _first_chunk_dirty = true;
+    }
+  }
+
   // template specialization for types that support compare operator
   virtual void pushUpdateRangeX(const Point& p)
   {
@@ -425,10 +675,6 @@ protected:
         {
           _range_x.min = p.x;
         }
-        else
-        {
-          _range_x_dirty = true;
-        }
       }
     }
   }
@@ -438,6 +684,12 @@ protected:
   {
     if constexpr (std::is_arithmetic_v<Value>)
     {
+      if (_points.empty())
+      {
+        _range_y_dirty = false;
+        _range_y.min = p.y;
+        _range_y.max = p.y;
+      }
       if (!_range_y_dirty)
       {
         if (p.y > _range_y.max)
@@ -448,10 +700,6 @@ protected:
         {
           _range_y.min = p.y;
         }
-        else
-        {
-          _range_y_dirty = true;
-        }
       }
     }
   }
@@ -30,6 +30,7 @@ struct TimeseriesRef
   unsigned size() const;
 
   PJ::PlotData* _plot_data = nullptr;
+  mutable int _index_hint = -1;
 };
 
 //-----------------------
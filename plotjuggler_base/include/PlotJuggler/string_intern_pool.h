@@ -0,0 +1,67 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_STRING_INTERN_POOL_H
+#define PJ_STRING_INTERN_POOL_H
+
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "PlotJuggler/string_ref_sso.h"
+
+namespace PJ
+{
+/**
+ * @brief Thread-safe pool of immutable strings, shared by all the StringSeries.
+ *
+ * Each distinct string is stored only once and never moved. Every call of
+ * intern() adds a reference to the string, that must be given back with
+ * release(); the StringRef remains valid until then. The string is freed when
+ * its last reference is released.
+ */
+class StringInternPool
+{
+public:
+  StringInternPool() = default;
+
+  StringInternPool(const StringInternPool&) = delete;
+  StringInternPool& operator=(const StringInternPool&) = delete;
+
+  /// The pool used by StringSeries.
+  static StringInternPool& global();
+
+  /// Return a reference to the pooled copy of the string, adding it if needed.
+  StringRef intern(std::string_view str);
+
+  /// Release a reference obtained with intern().
+  void release(StringRef str);
+
+  /// Number of distinct strings.
+  size_t size() const;
+
+  /// Total size of the strings, in bytes.
+  size_t memoryUsage() const;
+
+private:
+  struct Entry
+  {
+    std::string str;
+    // incremented with the shared lock, decremented with the exclusive one
+    std::atomic<size_t> references;
+  };
+
+  mutable std::shared_mutex _mutex;
+  // the key is a view of Entry::str
+  std::unordered_map<std::string_view, std::unique_ptr<Entry>> _entries;
+  size_t _memory_usage = 0;
+};
+
+}  // namespace PJ
+
+#endif  // PJ_STRING_INTERN_POOL_H
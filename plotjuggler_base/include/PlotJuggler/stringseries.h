@@ -9,8 +9,11 @@
 
 #include "PlotJuggler/timeseries.h"
 #include "PlotJuggler/string_ref_sso.h"
+#include "PlotJuggler/string_intern_pool.h"
 #include <algorithm>
+#include <string_view>
 #include <unordered_set>
+#include <utility>
 
 namespace PJ
 {
@@ -25,15 +28,37 @@ public:
   }
 
   StringSeries(const StringSeries& other) = delete;
-  StringSeries(StringSeries&& other) = default;
+
+  StringSeries(StringSeries&& other)
+    : TimeseriesBase<StringRef>(std::move(other))
+    , _interned(std::exchange(other._interned, {}))
+    , _last_long_str(std::exchange(other._last_long_str, {}))
+  {
+  }
 
   StringSeries& operator=(const StringSeries& other) = delete;
-  StringSeries& operator=(StringSeries&& other) = default;
+
+  StringSeries& operator=(StringSeries&& other)
+  {
+    if (this != &other)
+    {
+      releaseStrings();
+      TimeseriesBase<StringRef>::operator=(std::move(other));
+      _interned = std::exchange(other._interned, {});
+      _last_long_str = std::exchange(other._last_long_str, {});
+    }
+    return *this;
+  }
+
+  ~StringSeries() override
+  {
+    releaseStrings();
+  }
 
   virtual void clear() override
   {
-    _storage.clear();
     TimeseriesBase<StringRef>::clear();
+    releaseStrings();
   }
 
   void pushBack(const Point& p) override
@@ -54,25 +79,43 @@ public:
     {
       // the object stroed the string already, just push it
       TimeseriesBase<StringRef>::pushBack(std::move(p));
+      return;
     }
-    else
-    {
-      // save a copy of the string in the flywheel structure _storage
-      // create a reference to that cached value.
-      _tmp_str.assign(str.data(), str.size());
 
-      auto it = _storage.find(_tmp_str);
-      if (it == _storage.end())
+    // Long strings are stored once in the global pool, shared by all the series.
+    // Consecutive samples often have the same value: in that case, reuse the
+    // previous reference, without hashing or locking the pool.
+    const std::string_view view(str.data(), str.size());
+    if (_last_long_str.data() == nullptr ||
+        view != std::string_view(_last_long_str.data(), _last_long_str.size()))
+    {
+      // the series holds a single reference to each string of the pool it uses
+      auto it = _interned.find(view);
+      if (it == _interned.end())
       {
-        it = _storage.insert(_tmp_str).first;
+        StringRef pooled = StringInternPool::global().intern(view);
+        it = _interned.insert(std::string_view(pooled.data(), pooled.size())).first;
       }
-      TimeseriesBase<StringRef>::pushBack({ p.x, StringRef(*it) });
+      _last_long_str = StringRef(it->data(), it->size());
     }
+    TimeseriesBase<StringRef>::pushBack({ p.x, _last_long_str });
   }
 
 private:
-  std::string _tmp_str;
-  std::unordered_set<std::string> _storage;
+  // strings of the pool referenced by this series, released by clear()
+  std::unordered_set<std::string_view> _interned;
+  // last string (not SSO) that was pushed
+  StringRef _last_long_str;
+
+  void releaseStrings()
+  {
+    for (const auto& str : _interned)
+    {
+      StringInternPool::global().release(StringRef(str.data(), str.size()));
+    }
+    _interned.clear();
+    _last_long_str = {};
+  }
 };
 
 }  // namespace PJ
@@ -9,9 +9,29 @@
 
 #include "plotdatabase.h"
 #include <algorithm>
+#include <cmath>
 
 namespace PJ
 {
+template <typename Value>
+class TimeseriesBase;
+
+/**
+ * @brief Receives the changes of the points of a TimeseriesBase.
+ * To keep the cost of pushBack() low, the observer is called at the first change
+ * only, until it calls TimeseriesBase::acknowledgeChanges().
+ */
+template <typename Value>
+class TimeseriesObserver
+{
+public:
+  virtual ~TimeseriesObserver() = default;
+
+  virtual void onPointsChanged(TimeseriesBase<Value>* series) = 0;
+
+  virtual void onDestroyed(TimeseriesBase<Value>* series) = 0;
+};
+
 template <typename Value>
 class TimeseriesBase : public PlotDataBase<double, Value>
 {
@@ -19,6 +39,19 @@ protected:
   double _max_range_x;
   using PlotDataBase<double, Value>::_points;
 
+  // the observer watches this object: it is not transferred by a move
+  TimeseriesObserver<Value>* _observer = nullptr;
+  bool _observer_notified = false;
+
+  void notifyObserver()
+  {
+    if (_observer && !_observer_notified)
+    {
+      _observer_notified = true;
+      _observer->onPointsChanged(this);
+    }
+  }
+
 public:
   using Point = typename PlotDataBase<double, Value>::Point;
 
@@ -29,10 +62,80 @@ public:
   }
 
   TimeseriesBase(const TimeseriesBase& other) = delete;
-  TimeseriesBase(TimeseriesBase&& other) = default;
+
+  TimeseriesBase(TimeseriesBase&& other)
+    : PlotDataBase<double, Value>(std::move(other)), _max_range_x(other._max_range_x)
+  {
+    other.notifyObserver();
+  }
 
   TimeseriesBase& operator=(const TimeseriesBase& other) = delete;
-  TimeseriesBase& operator=(TimeseriesBase&& other) = default;
+
+  TimeseriesBase& operator=(TimeseriesBase&& other)
+  {
+    if (this != &other)
+    {
+      PlotDataBase<double, Value>::operator=(std::move(other));
+      _max_range_x = other._max_range_x;
+      notifyObserver();
+      other.notifyObserver();
+    }
+    return *this;
+  }
+
+  ~TimeseriesBase() override
+  {
+    if (_observer)
+    {
+      _observer->onDestroyed(this);
+    }
+  }
+
+  /// See TimeseriesObserver. Use nullptr to detach the current observer.
+  void setObserver(TimeseriesObserver<Value>* observer)
+  {
+    if (observer != _observer)
+    {
+      _observer = observer;
+      _observer_notified = false;
+    }
+  }
+
+  /// Called by the observer, to be notified again at the next change.
+  void acknowledgeChanges()
+  {
+    _observer_notified = false;
+  }
+
+  void clonePoints(const TimeseriesBase& other)
+  {
+    PlotDataBase<double, Value>::clonePoints(other);
+    notifyObserver();
+  }
+
+  void clear() override
+  {
+    PlotDataBase<double, Value>::clear();
+    notifyObserver();
+  }
+
+  void insert(typename PlotDataBase<double, Value>::Iterator it, Point&& p) override
+  {
+    PlotDataBase<double, Value>::insert(it, std::move(p));
+    notifyObserver();
+  }
+
+  void popFront() override
+  {
+    PlotDataBase<double, Value>::popFront();
+    notifyObserver();
+  }
+
+  void popFront(size_t count) override
+  {
+    PlotDataBase<double, Value>::popFront(count);
+    notifyObserver();
+  }
 
   virtual bool isTimeseries() const override
   {
@@ -50,14 +153,53 @@ public:
     return _max_range_x;
   }
 
+  /// The points are sorted by time: the range is given by the first and last one.
+  RangeOpt rangeX() const override
+  {
+    if (_points.empty())
+    {
+      return std::nullopt;
+    }
+    return Range{ _points.front().x, _points.back().x };
+  }
+
   int getIndexFromX(double x) const;
 
+  /**
+   * @brief Same as getIndexFromX(x), but the search starts from hint, usually the
+   * index returned by a previous call. When x moves by small steps, as the
+   * tracker does during playback, the cost is amortized O(1).
+   * A negative hint is ignored.
+   */
+  int getIndexFromX(double x, int hint) const;
+
+  /// Index of the first point with x >= t, or size() if none.
+  /// The hint is used as in getIndexFromX(x, hint).
+  size_t lowerBound(double t, int hint = -1) const
+  {
+    return search<false>(t, hint);
+  }
+
+  /// Index of the first point with x > t, or size() if none.
+  /// The hint is used as in getIndexFromX(x, hint).
+  size_t upperBound(double t, int hint = -1) const
+  {
+    return search<true>(t, hint);
+  }
+
   std::optional<Value> getYfromX(double x) const
   {
     int index = getIndexFromX(x);
     return (index < 0) ? std::nullopt : std::optional(_points[index].y);
   }
 
+  /// Same as getYfromX(x), using and updating the index hint.
+  std::optional<Value> getYfromX(double x, int& hint) const
+  {
+    hint = getIndexFromX(x, hint);
+    return (hint < 0) ? std::nullopt : std::optional(_points[hint].y);
+  }
+
   void pushBack(const Point& p) override
   {
     auto temp = p;
@@ -79,22 +221,64 @@ public:
     {
       PlotDataBase<double, Value>::pushBack(std::move(p));
     }
+    notifyObserver();
     trimRange();
   }
 
+  /// Append a range of points. When the range is sorted and newer than the
+  /// current content, sorting and trimming are checked once for the whole range.
+  template <typename Iterator>
+  void pushBack(Iterator first, Iterator last)
+  {
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      if (first != last && (_points.empty() || first->x >= this->back().x) &&
+          std::is_sorted(first, last, TimeCompare))
+      {
+        for (auto it = first; it != last; ++it)
+        {
+          Point p = *it;
+          PlotDataBase<double, Value>::pushBack(std::move(p));
+        }
+        notifyObserver();
+        trimRange();
+        return;
+      }
+    }
+    for (auto it = first; it != last; ++it)
+    {
+      pushBack(*it);
+    }
+  }
+
 private:
+  // Remove the points older than _max_range_x, keeping at least two of them.
+  // The expired points are removed at once, instead of one by one.
   void trimRange()
   {
-    if(_max_range_x < std::numeric_limits<double>::max() && !_points.empty())
+    if (_max_range_x < std::numeric_limits<double>::max() && _points.size() > 2)
     {
       auto const back_point_x = _points.back().x;
-      while (_points.size() > 2 && (back_point_x - _points.front().x) > _max_range_x)
+      if ((back_point_x - _points.front().x) <= _max_range_x)
       {
-        this->popFront();
+        return;
       }
+      auto first_kept = std::partition_point(
+          _points.begin(), _points.end() - 2,
+          [&](const Point& p) { return (back_point_x - p.x) > _max_range_x; });
+      this->popFront(size_t(std::distance(_points.begin(), first_kept)));
     }
   }
 
+  // A point is "before" t if x < t, or x <= t when STRICT.
+  // Index of the first point that is not before t, searched from hint.
+  template <bool STRICT>
+  size_t search(double t, int hint) const;
+
+  // Same as search(), when the result is known to be in the range [lo, hi]
+  template <bool STRICT>
+  size_t searchRange(double t, size_t lo, size_t hi) const;
+
   static bool TimeCompare(const Point& a, const Point& b)
   {
     return a.x < b.x;
@@ -106,28 +290,113 @@ private:
 template <typename Value>
 inline int TimeseriesBase<Value>::getIndexFromX(double x) const
 {
-  if (_points.size() == 0)
+  return getIndexFromX(x, -1);
+}
+
+template <typename Value>
+inline int TimeseriesBase<Value>::getIndexFromX(double x, int hint) const
+{
+  const size_t size = _points.size();
+  if (size == 0)
   {
     return -1;
   }
-  auto lower =
-      std::lower_bound(_points.begin(), _points.end(), Point(x, {}), TimeCompare);
-  auto index = std::distance(_points.begin(), lower);
-
-  if (index >= _points.size())
+  size_t index = lowerBound(x, hint);
+  if (index >= size)
   {
-    return _points.size() - 1;
+    return int(size - 1);
   }
-  if (index < 0)
+  if (index > 0 &&
+      (std::abs(_points[index - 1].x - x) < std::abs(_points[index].x - x)))
   {
-    return 0;
+    index = index - 1;
   }
+  return int(index);
+}
 
-  if (index > 0 && (abs(_points[index - 1].x - x) < abs(_points[index].x - x)))
+template <typename Value>
+template <bool STRICT>
+inline size_t TimeseriesBase<Value>::search(double t, int hint) const
+{
+  const size_t size = _points.size();
+  auto before = [t](const Point& p) { return STRICT ? (p.x <= t) : (p.x < t); };
+
+  // the result is in the range [lo, hi]
+  size_t lo = 0;
+  size_t hi = size;
+
+  if (hint >= 0 && size > 0)
   {
-    index = index - 1;
+    // gallop from the hint, in the direction of t. Give up after a few steps:
+    // large jumps are better handled by the interpolation search.
+    const size_t MAX_STEP = 64;
+    size_t known = std::min(size_t(hint), size - 1);
+    size_t step = 1;
+    if (before(_points[known]))
+    {
+      while (known + step < size && before(_points[known + step]) && step < MAX_STEP)
+      {
+        known += step;
+        step *= 2;
+      }
+      lo = known + 1;
+      if (known + step < size && !before(_points[known + step]))
+      {
+        hi = known + step;
+      }
+    }
+    else
+    {
+      while (known >= step && !before(_points[known - step]) && step < MAX_STEP)
+      {
+        known -= step;
+        step *= 2;
+      }
+      hi = known;
+      if (known >= step && before(_points[known - step]))
+      {
+        lo = known - step + 1;
+      }
+    }
+  }
+  return searchRange<STRICT>(t, lo, hi);
+}
+
+template <typename Value>
+template <bool STRICT>
+inline size_t TimeseriesBase<Value>::searchRange(double t, size_t lo, size_t hi) const
+{
+  auto before = [t](const Point& p) { return STRICT ? (p.x <= t) : (p.x < t); };
+
+  // Interpolation search: timestamps are usually evenly spaced, therefore a
+  // few iterations shrink the range to a handful of points. The number of
+  // iterations is limited, to avoid the worst case of irregular data.
+  for (int i = 0; i < 4 && hi - lo > 16; i++)
+  {
+    if (!before(_points[lo]))
+    {
+      return lo;
+    }
+    if (before(_points[hi - 1]))
+    {
+      return hi;
+    }
+    const double x_lo = _points[lo].x;
+    const double x_hi = _points[hi - 1].x;
+    const double ratio = (t - x_lo) / (x_hi - x_lo);
+    size_t mid = lo + size_t(ratio * double(hi - 1 - lo));
+    mid = std::min(std::max(mid, lo), hi - 1);
+    if (before(_points[mid]))
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
   }
-  return index;
+  auto it = std::partition_point(_points.begin() + lo, _points.begin() + hi, before);
+  return size_t(std::distance(_points.begin(), it));
 }
 
 }  // namespace PJ
@@ -61,11 +61,22 @@ public:
 
   std::vector<const PlotData*>& dataSources();
 
+  std::vector<PlotData*>& dataDestinations();
+
   virtual void setData(PlotDataMapRef* data, const std::vector<const PlotData*>& src_vect,
                        std::vector<PlotData*>& dst_vect);
 
   virtual void calculate() = 0;
 
+  /** Return true if calculate() can be executed in a worker thread, concurrently
+   * with other transforms that don't read or write the same data.
+   * It must not access any widget or shared state.
+   */
+  virtual bool isThreadSafe() const
+  {
+    return false;
+  }
+
   unsigned order() const
   {
     return _order;
@@ -109,10 +120,28 @@ public:
   /// Index will increase monotonically, unless reset() is used.
   virtual std::optional<PlotData::Point> calculateNextPoint(size_t index) = 0;
 
+  /** Batch version of calculateNextPoint(), that can be overridden to process
+   * a contiguous block of points in a single call.
+   *
+   * @param first_index  index in dataSource() of input[0].
+   * @param input        contiguous copy of the points [first_index, first_index + count).
+   * @param count        number of points in input.
+   * @param output       vector where the resulting points must be appended.
+   *
+   * The default implementation calls calculateNextPoint() for each point.
+   */
+  virtual void calculateBatch(size_t first_index, const PlotData::Point* input,
+                              size_t count, std::vector<PlotData::Point>& output);
+
   const PlotData* dataSource() const;
 
 protected:
   double _last_timestamp = std::numeric_limits<double>::lowest();
+
+private:
+  static constexpr size_t BATCH_SIZE = 4096;
+  std::vector<PlotData::Point> _batch_input;
+  std::vector<PlotData::Point> _batch_output;
 };
 
 ///------ The factory to create instances of a SeriesTransform -------------
@@ -0,0 +1,308 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_GORILLA_CODEC_HPP
+#define PJ_GORILLA_CODEC_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace PJ
+{
+/**
+ * @brief Lossless compression of (time, value) samples, as described in the paper
+ * "Gorilla: A Fast, Scalable, In-Memory Time Series Database".
+ *
+ * - Timestamps: delta-of-delta of their IEEE 754 representation. When the sampling
+ *   period is regular, most timestamps take 1 bit.
+ * - Values: XOR with the previous value, storing only the meaningful bits.
+ *   A value equal to the previous one takes 1 bit.
+ *
+ * Samples must be decoded in the same order they were encoded.
+ */
+class GorillaEncoder
+{
+public:
+  GorillaEncoder() = default;
+
+  void push(double time, double value)
+  {
+    const uint64_t t = ToBits(time);
+    const uint64_t v = ToBits(value);
+    if (_count == 0)
+    {
+      write(t, 64);
+      write(v, 64);
+    }
+    else
+    {
+      const uint64_t delta = t - _prev_time;
+      writeDeltaOfDelta(delta - _prev_delta);
+      _prev_delta = delta;
+      writeXor(v ^ _prev_value);
+    }
+    _prev_time = t;
+    _prev_value = v;
+    _count++;
+  }
+
+  size_t count() const
+  {
+    return _count;
+  }
+
+  size_t sizeInBits() const
+  {
+    return _bits;
+  }
+
+  const std::vector<uint64_t>& words() const
+  {
+    return _words;
+  }
+
+  /// Release the encoded data, leaving the encoder empty.
+  std::vector<uint64_t> takeWords()
+  {
+    std::vector<uint64_t> out;
+    out.swap(_words);
+    out.shrink_to_fit();
+    *this = GorillaEncoder();
+    return out;
+  }
+
+  static uint64_t ToBits(double value)
+  {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  static double FromBits(uint64_t bits)
+  {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  static uint64_t LowMask(int n)
+  {
+    return (n >= 64) ? ~uint64_t(0) : ((uint64_t(1) << n) - 1);
+  }
+
+  static int CountLeadingZeros(uint64_t x)
+  {
+    int n = 0;
+    for (uint64_t mask = uint64_t(1) << 63; mask != 0 && (x & mask) == 0; mask >>= 1)
+    {
+      n++;
+    }
+    return n;
+  }
+
+  static int CountTrailingZeros(uint64_t x)
+  {
+    int n = 0;
+    for (uint64_t mask = 1; mask != 0 && (x & mask) == 0; mask <<= 1)
+    {
+      n++;
+    }
+    return n;
+  }
+
+private:
+  std::vector<uint64_t> _words;
+  size_t _bits = 0;
+  size_t _count = 0;
+  uint64_t _prev_time = 0;
+  uint64_t _prev_delta = 0;
+  uint64_t _prev_value = 0;
+  int _prev_leading = -1;
+  int _prev_trailing = 0;
+
+  // write the "size" least significant bits of "value", most significant first
+  void write(uint64_t value, int size)
+  {
+    while (size > 0)
+    {
+      const int offset = int(_bits % 64);
+      if (offset == 0)
+      {
+        _words.push_back(0);
+      }
+      const int room = 64 - offset;
+      const int n = (size < room) ? size : room;
+      const uint64_t chunk = (value >> (size - n)) & LowMask(n);
+      _words.back() |= chunk << (room - n);
+      _bits += size_t(n);
+      size -= n;
+    }
+  }
+
+  void writeDeltaOfDelta(uint64_t dod)
+  {
+    // zig-zag encoding: small negative numbers become small positive numbers
+    const int64_t signed_dod = int64_t(dod);
+    const uint64_t zz = (uint64_t(signed_dod) << 1) ^ uint64_t(signed_dod >> 63);
+    if (zz == 0)
+    {
+      write(0b0, 1);
+    }
+    else if (zz < (1u << 7))
+    {
+      write(0b10, 2);
+      write(zz, 7);
+    }
+    else if (zz < (1u << 9))
+    {
+      write(0b110, 3);
+      write(zz, 9);
+    }
+    else if (zz < (1u << 12))
+    {
+      write(0b1110, 4);
+      write(zz, 12);
+    }
+    else
+    {
+      write(0b1111, 4);
+      write(zz, 64);
+    }
+  }
+
+  void writeXor(uint64_t x)
+  {
+    if (x == 0)
+    {
+      write(0b0, 1);
+      return;
+    }
+    const int leading = CountLeadingZeros(x);
+    const int trailing = CountTrailingZeros(x);
+    if (_prev_leading >= 0 && leading >= _prev_leading && trailing >= _prev_trailing)
+    {
+      // the meaningful bits fit in the previous window
+      write(0b10, 2);
+      write(x >> _prev_trailing, 64 - _prev_leading - _prev_trailing);
+    }
+    else
+    {
+      const int length = 64 - leading - trailing;
+      write(0b11, 2);
+      write(uint64_t(leading), 6);
+      write(uint64_t(length - 1), 6);
+      write(x >> trailing, length);
+      _prev_leading = leading;
+      _prev_trailing = trailing;
+    }
+  }
+};
+
+class GorillaDecoder
+{
+public:
+  GorillaDecoder(const uint64_t* words, size_t count) : _words(words), _count(count)
+  {
+  }
+
+  /// Read the next sample. Returns false if all the samples were read.
+  bool next(double& time, double& value)
+  {
+    if (_index >= _count)
+    {
+      return false;
+    }
+    if (_index == 0)
+    {
+      _prev_time = read(64);
+      _prev_value = read(64);
+    }
+    else
+    {
+      _prev_delta += readDeltaOfDelta();
+      _prev_time += _prev_delta;
+      _prev_value ^= readXor();
+    }
+    _index++;
+    time = GorillaEncoder::FromBits(_prev_time);
+    value = GorillaEncoder::FromBits(_prev_value);
+    return true;
+  }
+
+private:
+  const uint64_t* _words;
+  size_t _count;
+  size_t _index = 0;
+  size_t _bits = 0;
+  uint64_t _prev_time = 0;
+  uint64_t _prev_delta = 0;
+  uint64_t _prev_value = 0;
+  int _prev_leading = 0;
+  int _prev_trailing = 0;
+
+  uint64_t read(int size)
+  {
+    uint64_t value = 0;
+    while (size > 0)
+    {
+      const int offset = int(_bits % 64);
+      const int room = 64 - offset;
+      const int n = (size < room) ? size : room;
+      const uint64_t chunk =
+          (_words[_bits / 64] >> (room - n)) & GorillaEncoder::LowMask(n);
+      value = (n >= 64) ? chunk : ((value << n) | chunk);
+      _bits += size_t(n);
+      size -= n;
+    }
+    return value;
+  }
+
+  uint64_t readDeltaOfDelta()
+  {
+    uint64_t zz = 0;
+    if (read(1) == 0)
+    {
+      return 0;
+    }
+    else if (read(1) == 0)
+    {
+      zz = read(7);
+    }
+    else if (read(1) == 0)
+    {
+      zz = read(9);
+    }
+    else if (read(1) == 0)
+    {
+      zz = read(12);
+    }
+    else
+    {
+      zz = read(64);
+    }
+    return (zz >> 1) ^ (~(zz & 1) + 1);
+  }
+
+  uint64_t readXor()
+  {
+    if (read(1) == 0)
+    {
+      return 0;
+    }
+    if (read(1) == 1)
+    {
+      _prev_leading = int(read(6));
+      _prev_trailing = 64 - _prev_leading - (int(read(6)) + 1);
+    }
+    const int length = 64 - _prev_leading - _prev_trailing;
+    return read(length) << _prev_trailing;
+  }
+};
+
+}  // namespace PJ
+
+#endif  // PJ_GORILLA_CODEC_HPP
@@ -0,0 +1,261 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_SLIDING_WINDOW_HPP
+#define PJ_SLIDING_WINDOW_HPP
+
+#include <deque>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+namespace PJ
+{
+/**
+ * @brief Incremental aggregation over a sliding window of (time, value) samples.
+ *
+ * The window is bounded either by a number of samples or by a time span.
+ * push() costs amortized O(1): sum, sum of squares and Welford mean/variance
+ * are updated when samples enter or leave the window, while min and max
+ * are maintained with two monotonic deques.
+ */
+class SlidingWindow
+{
+public:
+  enum Mode
+  {
+    SAMPLE_COUNT,
+    TIME_SPAN
+  };
+
+  SlidingWindow() = default;
+
+  /// Bound the window to the last N samples. Clears the current content.
+  void setSampleCount(size_t count)
+  {
+    _mode = SAMPLE_COUNT;
+    _sample_count = std::max<size_t>(count, 1);
+    clear();
+  }
+
+  /// Bound the window to the samples in (back_time - span, back_time].
+  /// Clears the current content.
+  void setTimeSpan(double span)
+  {
+    _mode = TIME_SPAN;
+    _time_span = span;
+    clear();
+  }
+
+  Mode mode() const
+  {
+    return _mode;
+  }
+
+  size_t sampleCount() const
+  {
+    return _sample_count;
+  }
+
+  double timeSpan() const
+  {
+    return _time_span;
+  }
+
+  void clear()
+  {
+    _samples.clear();
+    _min_queue.clear();
+    _max_queue.clear();
+    _sum = 0;
+    _sum_sqr = 0;
+    _mean = 0;
+    _m2 = 0;
+    _removed_since_refresh = 0;
+  }
+
+  void push(double t, double y)
+  {
+    const Sample sample = { t, y, _next_seq++ };
+    _samples.push_back(sample);
+
+    _sum += y;
+    _sum_sqr += y * y;
+
+    const double n = static_cast<double>(_samples.size());
+    const double delta = y - _mean;
+    _mean += delta / n;
+    _m2 += delta * (y - _mean);
+
+    while (!_min_queue.empty() && _min_queue.back().y >= y)
+    {
+      _min_queue.pop_back();
+    }
+    _min_queue.push_back(sample);
+
+    while (!_max_queue.empty() && _max_queue.back().y <= y)
+    {
+      _max_queue.pop_back();
+    }
+    _max_queue.push_back(sample);
+
+    if (_mode == SAMPLE_COUNT)
+    {
+      while (_samples.size() > _sample_count)
+      {
+        popFront();
+      }
+    }
+    else
+    {
+      while (_samples.size() > 1 && (t - _samples.front().t) >= _time_span)
+      {
+        popFront();
+      }
+    }
+  }
+
+  bool empty() const
+  {
+    return _samples.empty();
+  }
+
+  size_t size() const
+  {
+    return _samples.size();
+  }
+
+  double frontTime() const
+  {
+    return _samples.front().t;
+  }
+
+  double backTime() const
+  {
+    return _samples.back().t;
+  }
+
+  double sum() const
+  {
+    return _sum;
+  }
+
+  double mean() const
+  {
+    return _mean;
+  }
+
+  double rms() const
+  {
+    return _samples.empty() ? 0.0 : std::sqrt(std::max(0.0, _sum_sqr / size()));
+  }
+
+  /// Population variance of the samples in the window.
+  double variance() const
+  {
+    return _samples.empty() ? 0.0 : std::max(0.0, _m2 / size());
+  }
+
+  double stddev() const
+  {
+    return std::sqrt(variance());
+  }
+
+  double min() const
+  {
+    return _min_queue.front().y;
+  }
+
+  double max() const
+  {
+    return _max_queue.front().y;
+  }
+
+private:
+  struct Sample
+  {
+    double t;
+    double y;
+    uint64_t seq;
+  };
+
+  void popFront()
+  {
+    const Sample sample = _samples.front();
+    _samples.pop_front();
+
+    if (_min_queue.front().seq == sample.seq)
+    {
+      _min_queue.pop_front();
+    }
+    if (_max_queue.front().seq == sample.seq)
+    {
+      _max_queue.pop_front();
+    }
+
+    if (_samples.empty())
+    {
+      clear();
+      return;
+    }
+
+    // Running sums accumulate rounding errors when values are removed.
+    // Recompute them once every size() removals: still amortized O(1).
+    if (++_removed_since_refresh >= _samples.size())
+    {
+      refreshSums();
+      return;
+    }
+
+    const double y = sample.y;
+    _sum -= y;
+    _sum_sqr -= y * y;
+
+    const double n = static_cast<double>(_samples.size());
+    const double delta = y - _mean;
+    _mean -= delta / n;
+    _m2 -= delta * (y - _mean);
+  }
+
+  void refreshSums()
+  {
+    _sum = 0;
+    _sum_sqr = 0;
+    _mean = 0;
+    _m2 = 0;
+    double n = 0;
+    for (const auto& sample : _samples)
+    {
+      _sum += sample.y;
+      _sum_sqr += sample.y * sample.y;
+      n += 1.0;
+      const double delta = sample.y - _mean;
+      _mean += delta / n;
+      _m2 += delta * (sample.y - _mean);
+    }
+    _removed_since_refresh = 0;
+  }
+
+  Mode _mode = SAMPLE_COUNT;
+  size_t _sample_count = 1;
+  double _time_span = std::numeric_limits<double>::max();
+
+  std::deque<Sample> _samples;
+  std::deque<Sample> _min_queue;
+  std::deque<Sample> _max_queue;
+  uint64_t _next_seq = 0;
+
+  double _sum = 0;
+  double _sum_sqr = 0;
+  double _mean = 0;
+  double _m2 = 0;
+  size_t _removed_since_refresh = 0;
+};
+
+}  // namespace PJ
+
+#endif  // PJ_SLIDING_WINDOW_HPP
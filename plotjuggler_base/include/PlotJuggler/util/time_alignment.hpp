@@ -0,0 +1,219 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_TIME_ALIGNMENT_HPP
+#define PJ_TIME_ALIGNMENT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <vector>
+#include "PlotJuggler/plotdata.h"
+
+namespace PJ
+{
+enum class AlignmentPolicy
+{
+  /// sample closest in time; same rule as PlotData::getIndexFromX()
+  NEAREST,
+  /// last sample with x <= t (zero-order hold)
+  PREVIOUS,
+  /// linear interpolation between the two samples around t
+  LINEAR
+};
+
+/**
+ * @brief Resumable position inside a PlotData.
+ *
+ * It keeps the index found by the last query and passes it as hint to the
+ * lookups of PlotData (see TimeseriesBase::getIndexFromX(x, hint)), therefore
+ * walking the whole series costs O(N). Any index is a valid hint: the
+ * position survives when points are appended, trimmed or cleared, and when
+ * the time goes backward.
+ */
+class TimeseriesCursor
+{
+public:
+  TimeseriesCursor(const PlotData* series = nullptr)
+  {
+    setSeries(series);
+  }
+
+  /// Changing the series resets the cursor.
+  void setSeries(const PlotData* series)
+  {
+    if (series != _series)
+    {
+      _series = series;
+      reset();
+    }
+  }
+
+  const PlotData* series() const
+  {
+    return _series;
+  }
+
+  void reset()
+  {
+    _index = 0;
+  }
+
+  /// Index of the first point with x >= t (size() if none).
+  size_t lowerBound(double t)
+  {
+    _index = _series->lowerBound(t, hint());
+    return _index;
+  }
+
+  /// Index of the first point with x > t (size() if none).
+  size_t upperBound(double t)
+  {
+    _index = _series->upperBound(t, hint());
+    return _index;
+  }
+
+  /// Same result of PlotData::getIndexFromX(). Return -1 if the series is empty.
+  int nearestIndex(double t)
+  {
+    const int index = _series->getIndexFromX(t, hint());
+    _index = size_t(std::max(index, 0));
+    return index;
+  }
+
+  /// Value of the series at time t, according to the policy.
+  /// PREVIOUS and LINEAR don't extrapolate outside the range of the series.
+  std::optional<double> valueAt(double t, AlignmentPolicy policy)
+  {
+    const size_t size = _series->size();
+    if (size == 0)
+    {
+      return std::nullopt;
+    }
+    switch (policy)
+    {
+      case AlignmentPolicy::NEAREST:
+        return _series->at(size_t(nearestIndex(t))).y;
+
+      case AlignmentPolicy::PREVIOUS: {
+        const size_t index = upperBound(t);
+        if (index == 0)
+        {
+          return std::nullopt;
+        }
+        return _series->at(index - 1).y;
+      }
+
+      case AlignmentPolicy::LINEAR: {
+        const size_t index = lowerBound(t);
+        if (index >= size)
+        {
+          return std::nullopt;
+        }
+        const auto& p1 = _series->at(index);
+        if (p1.x == t)
+        {
+          return p1.y;
+        }
+        if (index == 0)
+        {
+          return std::nullopt;
+        }
+        const auto& p0 = _series->at(index - 1);
+        const double ratio = (t - p0.x) / (p1.x - p0.x);
+        return p0.y + ratio * (p1.y - p0.y);
+      }
+    }
+    return std::nullopt;
+  }
+
+private:
+  int hint() const
+  {
+    return int(std::min(_index, size_t(std::numeric_limits<int>::max())));
+  }
+
+  const PlotData* _series = nullptr;
+  size_t _index = 0;
+};
+
+/**
+ * @brief Align N series to a common time, moving one TimeseriesCursor for each.
+ *
+ * Typically used to sample additional series at the timestamps of a main one,
+ * in O(N + M) instead of O(N log M).
+ */
+class TimeAligner
+{
+public:
+  TimeAligner(AlignmentPolicy policy = AlignmentPolicy::NEAREST) : _policy(policy)
+  {
+  }
+
+  void setPolicy(AlignmentPolicy policy)
+  {
+    _policy = policy;
+  }
+
+  AlignmentPolicy policy() const
+  {
+    return _policy;
+  }
+
+  /// The cursors of the series that didn't change are preserved.
+  void setSeries(const std::vector<const PlotData*>& series)
+  {
+    _cursors.resize(series.size());
+    for (size_t i = 0; i < series.size(); i++)
+    {
+      _cursors[i].setSeries(series[i]);
+    }
+  }
+
+  size_t size() const
+  {
+    return _cursors.size();
+  }
+
+  TimeseriesCursor& cursor(size_t index)
+  {
+    return _cursors[index];
+  }
+
+  /// Value of the series at time t; NaN if not available.
+  double valueAt(size_t index, double t)
+  {
+    auto value = _cursors[index].valueAt(t, _policy);
+    return value ? *value : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  /// Write in output the value of each series at time t. output must have size().
+  void valuesAt(double t, double* output)
+  {
+    for (size_t i = 0; i < _cursors.size(); i++)
+    {
+      output[i] = valueAt(i, t);
+    }
+  }
+
+  /// Sample the series at each of the count timestamps (sorted).
+  void sample(size_t index, const double* time, size_t count, double* output)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      output[i] = valueAt(index, time[i]);
+    }
+  }
+
+private:
+  AlignmentPolicy _policy;
+  std::vector<TimeseriesCursor> _cursors;
+};
+
+}  // namespace PJ
+
+#endif  // PJ_TIME_ALIGNMENT_HPP
@@ -48,10 +48,24 @@ ScatterXYMap::iterator PlotDataMapRef::addScatterXY(const std::string& name,
   return addImpl(scatter_xy, name, group);
 }
 
+PlotDataMapRef::~PlotDataMapRef()
+{
+  for (auto& it : numeric)
+  {
+    it.second.setObserver(nullptr);
+  }
+}
+
 TimeseriesMap::iterator PlotDataMapRef::addNumeric(const std::string& name,
                                                    PlotGroup::Ptr group)
 {
-  return addImpl(numeric, name, group);
+  auto it = addImpl(numeric, name, group);
+  it->second.setObserver(this);
+  if (_selection.count(name) != 0)
+  {
+    _selected_series.insert(&it->second);
+  }
+  return it;
 }
 
 AnySeriesMap::iterator PlotDataMapRef::addUserDefined(const std::string& name,
@@ -75,7 +89,12 @@ PlotDataXY& PlotDataMapRef::getOrCreateScatterXY(const std::string& name,
 PlotData& PlotDataMapRef::getOrCreateNumeric(const std::string& name,
                                              PlotGroup::Ptr group)
 {
-  return getOrCreateImpl(numeric, name, group);
+  auto it = numeric.find(name);
+  if (it == numeric.end())
+  {
+    it = addNumeric(name, group);
+  }
+  return it->second;
 }
 
 StringSeries& PlotDataMapRef::getOrCreateStringSeries(const std::string& name,
@@ -124,6 +143,12 @@ std::unordered_set<std::string> PlotDataMapRef::getAllNames() const
 
 void PlotDataMapRef::clear()
 {
+  // the destroyed series don't need to be looked up one by one
+  _changed_series.clear();
+  _selected_series.clear();
+  _time_bounds.clear();
+  _selection_time_bounds.clear();
+
   numeric.clear();
   strings.clear();
   user_defined.clear();
@@ -171,4 +196,87 @@ bool PlotDataMapRef::erase(const std::string& name)
   return erased;
 }
 
+void PlotDataMapRef::setTimeBoundsSelection(std::unordered_set<std::string> names)
+{
+  _selection = std::move(names);
+  _selected_series.clear();
+  _selection_time_bounds.clear();
+  for (const auto& name : _selection)
+  {
+    auto it = numeric.find(name);
+    if (it != numeric.end())
+    {
+      _selected_series.insert(&it->second);
+      _selection_time_bounds.update(it->second);
+    }
+  }
+}
+
+void PlotDataMapRef::updateChangedTimeBounds() const
+{
+  for (PlotData* series : _changed_series)
+  {
+    series->acknowledgeChanges();
+    _time_bounds.update(*series);
+    if (_selected_series.count(series) != 0)
+    {
+      _selection_time_bounds.update(*series);
+    }
+  }
+  _changed_series.clear();
+}
+
+void PlotDataMapRef::onPointsChanged(PlotData* series)
+{
+  _changed_series.push_back(series);
+}
+
+void PlotDataMapRef::onDestroyed(PlotData* series)
+{
+  auto it = std::find(_changed_series.begin(), _changed_series.end(), series);
+  if (it != _changed_series.end())
+  {
+    _changed_series.erase(it);
+  }
+  _selected_series.erase(series);
+  _time_bounds.remove(*series);
+  _selection_time_bounds.remove(*series);
+}
+
+void TimeBounds::update(const PlotData& series)
+{
+  remove(series);
+  if (series.size() == 0)
+  {
+    return;
+  }
+  Entry entry = { series.front().x, series.back().x, series.size() };
+  _fronts.insert(entry.front);
+  _backs.insert(entry.back);
+  _sizes.insert(entry.size);
+  _entries.insert({ &series, entry });
+}
+
+void TimeBounds::remove(const PlotData& series)
+{
+  auto it = _entries.find(&series);
+  if (it == _entries.end())
+  {
+    return;
+  }
+  const Entry& entry = it->second;
+  _fronts.erase(_fronts.find(entry.front));
+  _backs.erase(_backs.find(entry.back));
+  _sizes.erase(_sizes.find(entry.size));
+  _entries.erase(it);
+}
+
+void TimeBounds::clear()
+{
+  _entries.clear();
+  _fronts.clear();
+  _backs.clear();
+  _sizes.clear();
+}
+
 }  // namespace PJ
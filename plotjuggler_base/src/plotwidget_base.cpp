@@ -10,6 +10,7 @@
 #include "plotmagnifier.h"
 #include "plotzoomer.h"
 #include "plotlegend.h"
+#include "raster_canvas.h"
 
 #include "qwt_axis.h"
 #include "qwt_legend.h"
@@ -350,7 +351,9 @@ PlotWidgetBase::PlotWidgetBase(QWidget* parent)
   }
   else
   {
-    auto canvas = new QwtPlotCanvas();
+    // the curves of the plots are drawn by multiple threads
+    bool parallel_render = settings.value("Preferences::parallel_render", false).toBool();
+    auto canvas = parallel_render ? new RasterCanvas() : new QwtPlotCanvas();
     canvas->setFrameStyle(QFrame::NoFrame);
     canvas->setFrameStyle(QFrame::Box | QFrame::Plain);
     canvas->setLineWidth(1);
@@ -0,0 +1,188 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "raster_canvas.h"
+#include <algorithm>
+#include <limits>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QtConcurrent>
+#include "qwt_plot.h"
+#include "qwt_plot_item.h"
+
+namespace
+{
+std::vector<RasterCanvas*>& PendingCanvases()
+{
+  static std::vector<RasterCanvas*> canvases;
+  return canvases;
+}
+
+// the items that can be drawn in a worker thread
+bool IsRasterized(const QwtPlotItem* item)
+{
+  return item->rtti() == QwtPlotItem::Rtti_PlotCurve ||
+         item->rtti() == QwtPlotItem::Rtti_PlotGrid;
+}
+
+void DrawItem(QPainter* painter, const QwtPlotItem* item, const QwtScaleMap& x_map,
+              const QwtScaleMap& y_map, const QRectF& canvas_rect)
+{
+  painter->save();
+  painter->setRenderHint(QPainter::Antialiasing,
+                         item->testRenderHint(QwtPlotItem::RenderAntialiased));
+  item->draw(painter, x_map, y_map, canvas_rect);
+  painter->restore();
+}
+}  // namespace
+
+RasterCanvas::RasterCanvas(QwtPlot* plot) : QwtPlotCanvas(plot)
+{
+}
+
+RasterCanvas::~RasterCanvas()
+{
+  auto& pending = PendingCanvases();
+  pending.erase(std::remove(pending.begin(), pending.end(), this), pending.end());
+}
+
+void RasterCanvas::invalidateBackingStore()
+{
+  _image = QImage();
+  QwtPlotCanvas::invalidateBackingStore();
+}
+
+void RasterCanvas::replot()
+{
+  invalidateBackingStore();
+  if (!_pending)
+  {
+    _pending = true;
+    PendingCanvases().push_back(this);
+  }
+  update(contentsRect());
+}
+
+bool RasterCanvas::prepare()
+{
+  _layers.clear();
+  _image = QImage();
+
+  const QwtPlot* qwt_plot = plot();
+  if (!qwt_plot || !isVisible() || testAttribute(Qt::WA_StyledBackground) ||
+      borderRadius() > 0.0)
+  {
+    return false;
+  }
+
+  double top_layer_z = std::numeric_limits<double>::lowest();
+  double overlay_z = std::numeric_limits<double>::max();
+  for (const QwtPlotItem* item : qwt_plot->itemList())
+  {
+    if (!item->isVisible())
+    {
+      continue;
+    }
+    if (IsRasterized(item))
+    {
+      _layers.push_back({ item, qwt_plot->canvasMap(item->xAxis()),
+                          qwt_plot->canvasMap(item->yAxis()) });
+      top_layer_z = std::max(top_layer_z, item->z());
+    }
+    else
+    {
+      overlay_z = std::min(overlay_z, item->z());
+    }
+  }
+  // for instance, a background image below the curves
+  if (_layers.empty() || overlay_z <= top_layer_z)
+  {
+    _layers.clear();
+    return false;
+  }
+
+  _size = size();
+  _pixel_ratio = devicePixelRatioF();
+  _background = palette().brush(backgroundRole());
+  _contents_rect = contentsRect();
+  return true;
+}
+
+void RasterCanvas::rasterize()
+{
+  QImage image(_size * _pixel_ratio, QImage::Format_ARGB32_Premultiplied);
+  image.setDevicePixelRatio(_pixel_ratio);
+
+  QPainter painter(&image);
+  painter.fillRect(QRect(QPoint(0, 0), _size), _background);
+  painter.setClipRect(_contents_rect);
+  for (const auto& layer : _layers)
+  {
+    DrawItem(&painter, layer.item, layer.x_map, layer.y_map, _contents_rect);
+  }
+  painter.end();
+
+  _image = std::move(image);
+}
+
+void RasterCanvas::rasterizePending()
+{
+  std::vector<RasterCanvas*> canvases;
+  for (RasterCanvas* canvas : PendingCanvases())
+  {
+    canvas->_pending = false;
+    if (canvas->prepare())
+    {
+      canvases.push_back(canvas);
+    }
+  }
+  PendingCanvases().clear();
+
+  QtConcurrent::blockingMap(canvases, [](RasterCanvas* canvas) { canvas->rasterize(); });
+}
+
+void RasterCanvas::drawOverlay(QPainter* painter) const
+{
+  const QwtPlot* qwt_plot = plot();
+  const QRectF canvas_rect = contentsRect();
+  for (const QwtPlotItem* item : qwt_plot->itemList())
+  {
+    if (item->isVisible() && !IsRasterized(item))
+    {
+      DrawItem(painter, item, qwt_plot->canvasMap(item->xAxis()),
+               qwt_plot->canvasMap(item->yAxis()), canvas_rect);
+    }
+  }
+}
+
+void RasterCanvas::paintEvent(QPaintEvent* event)
+{
+  if (_pending)
+  {
+    rasterizePending();
+  }
+
+  if (_image.isNull() || _size != size())
+  {
+    _image = QImage();
+    QwtPlotCanvas::paintEvent(event);
+    return;
+  }
+
+  QPainter painter(this);
+  painter.setClipRegion(event->region());
+  painter.drawImage(QPointF(0, 0), _image);
+
+  painter.save();
+  painter.setClipRect(contentsRect(), Qt::IntersectClip);
+  drawOverlay(&painter);
+  painter.restore();
+
+  if (frameWidth() > 0)
+  {
+    drawBorder(&painter);
+  }
+}
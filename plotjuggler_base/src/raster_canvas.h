@@ -0,0 +1,79 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RASTER_CANVAS_H
+#define RASTER_CANVAS_H
+
+#include <vector>
+#include <QBrush>
+#include <QImage>
+#include "qwt_plot_canvas.h"
+#include "qwt_scale_map.h"
+
+class QwtPlotItem;
+
+/**
+ * @brief Canvas that draws its curves in a worker thread.
+ *
+ * replot() only marks the canvas as pending. When the first pending canvas is
+ * painted, the curves and the grid of all the pending canvases that are visible
+ * are drawn into images, in parallel, by the global thread pool. Each canvas
+ * then copies its image and draws the remaining items (markers, tracker, legend)
+ * on top of it, in the GUI thread.
+ *
+ * The GUI thread waits for the workers, therefore the series are not modified
+ * while they are read. A canvas whose items can't be split in these two layers
+ * is drawn as usual.
+ */
+class RasterCanvas : public QwtPlotCanvas
+{
+  Q_OBJECT
+
+public:
+  explicit RasterCanvas(QwtPlot* plot = nullptr);
+
+  ~RasterCanvas() override;
+
+  // overrides QwtPlotAbstractCanvas::invalidateBackingStore(); QwtPlot also
+  // invokes it by name
+  Q_INVOKABLE void invalidateBackingStore() override;
+
+public slots:
+
+  // hides QwtPlotCanvas::replot(), that QwtPlot invokes by name
+  void replot();
+
+protected:
+  void paintEvent(QPaintEvent* event) override;
+
+private:
+  struct Layer
+  {
+    const QwtPlotItem* item;
+    QwtScaleMap x_map;
+    QwtScaleMap y_map;
+  };
+
+  // state of the plot, captured in the GUI thread
+  std::vector<Layer> _layers;
+  QSize _size;
+  qreal _pixel_ratio = 1.0;
+  QBrush _background;
+  QRectF _contents_rect;
+
+  QImage _image;
+  bool _pending = false;
+
+  bool prepare();
+
+  void rasterize();
+
+  void drawOverlay(QPainter* painter) const;
+
+  static void rasterizePending();
+};
+
+#endif  // RASTER_CANVAS_H
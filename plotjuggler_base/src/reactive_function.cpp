@@ -185,8 +185,8 @@ void TimeseriesRef::set(unsigned index, double x, double y)
 
 double TimeseriesRef::atTime(double t) const
 {
-  int i = _plot_data->getIndexFromX(t);
-  return _plot_data->at(i).y;
+  _index_hint = _plot_data->getIndexFromX(t, _index_hint);
+  return _plot_data->at(_index_hint).y;
 }
 
 unsigned TimeseriesRef::size() const
@@ -0,0 +1,70 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "PlotJuggler/string_intern_pool.h"
+#include <mutex>
+
+namespace PJ
+{
+StringInternPool& StringInternPool::global()
+{
+  static StringInternPool pool;
+  return pool;
+}
+
+StringRef StringInternPool::intern(std::string_view str)
+{
+  {
+    // most of the time, the string is in the pool already
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    auto it = _entries.find(str);
+    if (it != _entries.end())
+    {
+      it->second->references++;
+      return StringRef(it->first.data(), it->first.size());
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(_mutex);
+  // another thread may have added it in the meantime
+  auto it = _entries.find(str);
+  if (it == _entries.end())
+  {
+    auto entry = std::make_unique<Entry>();
+    entry->str.assign(str);
+    entry->references = 0;
+    _memory_usage += entry->str.size();
+    const std::string_view key(entry->str);
+    it = _entries.emplace(key, std::move(entry)).first;
+  }
+  it->second->references++;
+  return StringRef(it->first.data(), it->first.size());
+}
+
+void StringInternPool::release(StringRef str)
+{
+  std::unique_lock<std::shared_mutex> lock(_mutex);
+  auto it = _entries.find(std::string_view(str.data(), str.size()));
+  if (it != _entries.end() && --it->second->references == 0)
+  {
+    _memory_usage -= it->second->str.size();
+    _entries.erase(it);
+  }
+}
+
+size_t StringInternPool::size() const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  return _entries.size();
+}
+
+size_t StringInternPool::memoryUsage() const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  return _memory_usage;
+}
+
+}  // namespace PJ
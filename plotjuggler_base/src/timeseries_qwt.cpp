@@ -58,11 +58,12 @@ RangeOpt QwtTimeseries::getVisualizationRangeY(Range range_X)
 
 std::optional<QPointF> QwtTimeseries::sampleFromTime(double t)
 {
-  int index = _ts_data->getIndexFromX(t);
+  int index = _ts_data->getIndexFromX(t, _index_hint);
   if (index < 0)
   {
     return {};
   }
+  _index_hint = index;
   const auto& p = plotData()->at(size_t(index));
   return QPointF(p.x, p.y);
 }
@@ -54,6 +54,11 @@ public:
 
   void setTimeOffset(double offset);
 
+  double timeOffset() const
+  {
+    return _time_offset;
+  }
+
   virtual RangeOpt getVisualizationRangeX() override;
 
   virtual RangeOpt getVisualizationRangeY(Range range_X) override;
@@ -67,6 +72,8 @@ public:
 protected:
   const PlotData* _ts_data;
   double _time_offset = 0.0;
+  // index returned by the last call of sampleFromTime()
+  int _index_hint = -1;
 };
 
 //------------------------------------
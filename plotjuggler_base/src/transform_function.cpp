@@ -19,6 +19,11 @@ std::vector<const PlotData*>& TransformFunction::dataSources()
   return _src_vector;
 }
 
+std::vector<PlotData*>& TransformFunction::dataDestinations()
+{
+  return _dst_vector;
+}
+
 void TransformFunction::setData(PlotDataMapRef* data,
                                 const std::vector<const PlotData*>& src_vect,
                                 std::vector<PlotData*>& dst_vect)
@@ -59,20 +64,37 @@ void TransformFunction_SISO::calculate()
   int pos = src_data->getIndexFromX(_last_timestamp);
   size_t index = pos < 0 ? 0 : static_cast<size_t>(pos);
 
+  while (index < src_data->size() && src_data->at(index).x < _last_timestamp)
+  {
+    index++;
+  }
+
   while (index < src_data->size())
   {
-    const auto& in_point = src_data->at(index);
+    const size_t count = std::min(BATCH_SIZE, src_data->size() - index);
+    auto first = src_data->begin() + index;
+    _batch_input.assign(first, first + count);
+    _batch_output.clear();
 
-    if (in_point.x >= _last_timestamp)
+    calculateBatch(index, _batch_input.data(), count, _batch_output);
+
+    dst_data->pushBack(_batch_output.begin(), _batch_output.end());
+    _last_timestamp = _batch_input.back().x;
+    index += count;
+  }
+}
+
+void TransformFunction_SISO::calculateBatch(size_t first_index,
+                                            const PlotData::Point* input, size_t count,
+                                            std::vector<PlotData::Point>& output)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    auto out_point = calculateNextPoint(first_index + i);
+    if (out_point)
     {
-      auto out_point = calculateNextPoint(index);
-      if (out_point)
-      {
-        dst_data->pushBack(std::move(out_point.value()));
-      }
-      _last_timestamp = in_point.x;
+      output.push_back(out_point.value());
     }
-    index++;
   }
 }
 
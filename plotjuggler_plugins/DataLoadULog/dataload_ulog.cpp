@@ -58,10 +58,11 @@ bool DataLoadULog::readDataFromFile(FileLoadInfo* fileload_info,
 
       auto series = plot_data.addNumeric(series_name);
 
-      for (size_t i = 0; i < data.second.size(); i++)
+      const ULogParser::Column& column = data.second;
+      for (size_t i = 0; i < column.size(); i++)
       {
         double msg_time = static_cast<double>(timeseries.timestamps[i]) * 0.000001;
-        PlotData::Point point(msg_time, data.second[i]);
+        PlotData::Point point(msg_time, column.at(i));
         series->second.pushBack(point);
       }
     }
@@ -162,88 +162,99 @@ char* ULogParser::parseSimpleDataMessage(Timeseries& timeseries, const Format* f
 
     for (int array_pos = 0; array_pos < field.array_size; array_pos++)
     {
-      double value = 0;
-      switch (field.type)
+      if (field.type == OTHER)
       {
-        case UINT8: {
-          value = static_cast<double>(*reinterpret_cast<uint8_t*>(message));
-          message += 1;
-        }
-        break;
-        case INT8: {
-          value = static_cast<double>(*reinterpret_cast<int8_t*>(message));
-          message += 1;
-        }
-        break;
-        case UINT16: {
-          value = static_cast<double>(*reinterpret_cast<uint16_t*>(message));
-          message += 2;
-        }
-        break;
-        case INT16: {
-          value = static_cast<double>(*reinterpret_cast<int16_t*>(message));
-          message += 2;
-        }
-        break;
-        case UINT32: {
-          value = static_cast<double>(*reinterpret_cast<uint32_t*>(message));
-          message += 4;
-        }
-        break;
-        case INT32: {
-          value = static_cast<double>(*reinterpret_cast<int32_t*>(message));
-          message += 4;
-        }
-        break;
-        case UINT64: {
-          value = static_cast<double>(*reinterpret_cast<uint64_t*>(message));
-          message += 8;
-        }
-        break;
-        case INT64: {
-          value = static_cast<double>(*reinterpret_cast<int64_t*>(message));
-          message += 8;
-        }
-        break;
-        case FLOAT: {
-          value = static_cast<double>(*reinterpret_cast<float*>(message));
-          message += 4;
-        }
-        break;
-        case DOUBLE: {
-          value = (*reinterpret_cast<double*>(message));
-          message += 8;
-        }
-        break;
-        case CHAR: {
-          value = static_cast<double>(*reinterpret_cast<char*>(message));
-          message += 1;
-        }
-        break;
-        case BOOL: {
-          value = static_cast<double>(*reinterpret_cast<bool*>(message));
-          message += 1;
-        }
-        break;
-        case OTHER: {
-          // recursion!!!
-          auto child_format = _formats.at(field.other_type_ID);
-          message += sizeof(uint64_t);  // skip timestamp
-          message = parseSimpleDataMessage(timeseries, &child_format, message, index);
-        }
-        break;
-
-      }  // end switch
-
-      if (field.type != OTHER)
+        // recursion!!!
+        auto child_format = _formats.at(field.other_type_ID);
+        message += sizeof(uint64_t);  // skip timestamp
+        message = parseSimpleDataMessage(timeseries, &child_format, message, index);
+      }
+      else
       {
-        timeseries.data[(*index)++].second.push_back(value);
+        // the value is copied as it is, and converted to double only when read
+        message += timeseries.data[(*index)++].second.push(message);
       }
     }  // end for
   }
   return message;
 }
 
+size_t ULogParser::TypeWidth(FormatType type)
+{
+  switch (type)
+  {
+    case UINT8:
+    case INT8:
+    case CHAR:
+    case BOOL:
+      return 1;
+    case UINT16:
+    case INT16:
+      return 2;
+    case UINT32:
+    case INT32:
+    case FLOAT:
+      return 4;
+    case UINT64:
+    case INT64:
+    case DOUBLE:
+      return 8;
+    case OTHER:
+      break;
+  }
+  return 0;
+}
+
+ULogParser::Column::Column(FormatType type) : _type(type), _width(TypeWidth(type))
+{
+}
+
+namespace
+{
+template <typename T>
+double ReadAs(const char* data)
+{
+  T value;
+  memcpy(&value, data, sizeof(T));
+  return static_cast<double>(value);
+}
+}  // namespace
+
+double ULogParser::Column::at(size_t index) const
+{
+  const char* data = _bytes.data() + index * _width;
+  switch (_type)
+  {
+    case UINT8:
+      return ReadAs<uint8_t>(data);
+    case INT8:
+      return ReadAs<int8_t>(data);
+    case UINT16:
+      return ReadAs<uint16_t>(data);
+    case INT16:
+      return ReadAs<int16_t>(data);
+    case UINT32:
+      return ReadAs<uint32_t>(data);
+    case INT32:
+      return ReadAs<int32_t>(data);
+    case UINT64:
+      return ReadAs<uint64_t>(data);
+    case INT64:
+      return ReadAs<int64_t>(data);
+    case FLOAT:
+      return ReadAs<float>(data);
+    case DOUBLE:
+      return ReadAs<double>(data);
+    case CHAR:
+      return ReadAs<char>(data);
+    case BOOL:
+      return ReadAs<bool>(data);
+    case OTHER:
+      break;
+  }
+  return 0;
+}
+
 const std::map<std::string, ULogParser::Timeseries>& ULogParser::getTimeseriesMap() const
 {
   return _timeseries;
@@ -792,7 +803,7 @@ ULogParser::Timeseries ULogParser::createTimeseries(const ULogParser::Format* fo
         }
         if (field.type != OTHER)
         {
-          timeseries.data.push_back({ new_prefix + array_suffix, std::vector<double>() });
+          timeseries.data.push_back({ new_prefix + array_suffix, Column(field.type) });
         }
         else
         {
@@ -104,10 +104,50 @@ public:
     const Format* format;
   };
 
+  /**
+   * Values of a field, stored with the width of their type in the log
+   * (1 byte for uint8 and bool, 4 bytes for float, etc.).
+   * They are converted to double only when read.
+   */
+  class Column
+  {
+  public:
+    explicit Column(FormatType type);
+
+    FormatType type() const
+    {
+      return _type;
+    }
+
+    size_t size() const
+    {
+      return _size;
+    }
+
+    /// Append a value, reading its bytes from "data". Returns the number of bytes.
+    size_t push(const char* data)
+    {
+      _bytes.insert(_bytes.end(), data, data + _width);
+      _size++;
+      return _width;
+    }
+
+    double at(size_t index) const;
+
+  private:
+    FormatType _type;
+    size_t _width;
+    size_t _size = 0;
+    std::vector<char> _bytes;
+  };
+
+  /// Size in bytes of a field of this type (0 for OTHER).
+  static size_t TypeWidth(FormatType type);
+
   struct Timeseries
   {
     std::vector<uint64_t> timestamps;
-    std::vector<std::pair<std::string, std::vector<double>>> data;
+    std::vector<std::pair<std::string, Column>> data;
   };
 
 public:
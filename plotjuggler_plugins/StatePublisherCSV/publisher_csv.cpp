@@ -9,6 +9,8 @@
 #include <QMessageBox>
 #include <QSettings>
 #include <QByteArray>
+#include <QBuffer>
+#include <QApplication>
 #include "publisher_csv.h"
 
 StatePublisherCSV::StatePublisherCSV()
@@ -100,10 +102,8 @@ void StatePublisherCSV::setEnabled(bool enabled)
     });
 
     //--------------------
-    connect(_ui->buttonRangeFile, &QPushButton::clicked, this, [this]() {
-      auto csv_string = generateRangeCSV(_start_time, _end_time);
-      this->saveFile(csv_string);
-    });
+    connect(_ui->buttonRangeFile, &QPushButton::clicked, this,
+            [this]() { saveRangeFile(_start_time, _end_time); });
 
     //--------------------
     _dialog->setWindowFlag(Qt::WindowStaysOnTopHint);
@@ -216,17 +216,26 @@ void StatePublisherCSV::updateButtonsState()
   _ui->buttonStatisticsFile->setEnabled(enable);
 }
 
-void StatePublisherCSV::saveFile(QString text)
+QString StatePublisherCSV::askSaveFileName(const QString& filters,
+                                           QString* selected_filter)
 {
-  // QFileDialog::getSaveFileName(nullptr, "Save as CSV file", );
-
   QSettings settings;
   QString directory_path =
       settings.value("StatePublisherCSV.saveDirectory", QDir::currentPath()).toString();
 
   QString fileName = QFileDialog::getSaveFileName(
-      nullptr, tr("Save as CSV file"), directory_path, tr("CSV files (*.csv)"));
+      nullptr, tr("Save as file"), directory_path, filters, selected_filter);
+  if (!fileName.isEmpty())
+  {
+    directory_path = QFileInfo(fileName).absolutePath();
+    settings.setValue("StatePublisherCSV.saveDirectory", directory_path);
+  }
+  return fileName;
+}
 
+void StatePublisherCSV::saveFile(QString text)
+{
+  QString fileName = askSaveFileName(tr("CSV files (*.csv)"));
   if (fileName.isEmpty())
   {
     return;
@@ -246,17 +255,12 @@ void StatePublisherCSV::saveFile(QString text)
 
   file.write(text.toUtf8());
   file.close();
-
-  directory_path = QFileInfo(fileName).absolutePath();
-  settings.setValue("StatePublisherCSV.saveDirectory", directory_path);
 }
 
-QString StatePublisherCSV::generateRangeCSV(double time_start, double time_end)
+std::vector<NamedSeries> StatePublisherCSV::seriesInRange(double time_start,
+                                                          double time_end)
 {
-  using PlotPair = std::pair<std::string, const PJ::PlotData*>;
-
-  std::vector<PlotPair> ordered_plotdata;
-
+  std::vector<NamedSeries> series;
   for (const auto& it : _datamap->numeric)
   {
     if (it.second.size() == 0 || it.second.front().x > time_end ||
@@ -264,94 +268,82 @@ QString StatePublisherCSV::generateRangeCSV(double time_start, double time_end)
     {
       continue;
     }
-    ordered_plotdata.push_back({ it.first, &it.second });
+    series.push_back({ it.first, &it.second });
   }
-  const size_t plot_count = ordered_plotdata.size();
-
-  std::sort(ordered_plotdata.begin(), ordered_plotdata.end(),
-            [](const PlotPair& a, const PlotPair& b) { return a.first < b.first; });
-
-  // current index per plordata
-  std::vector<size_t> indices(plot_count, 0);
+  std::sort(series.begin(), series.end(),
+            [](const NamedSeries& a, const NamedSeries& b) { return a.name < b.name; });
+  return series;
+}
 
-  const auto NaN = std::numeric_limits<double>::quiet_NaN();
-  std::vector<double> row_values(plot_count, NaN);
+QString StatePublisherCSV::generateRangeCSV(double time_start, double time_end)
+{
+  QBuffer buffer;
+  buffer.open(QIODevice::WriteOnly);
+  WriteRangeCSV(buffer, seriesInRange(time_start, time_end), time_start, time_end);
+  return QString::fromUtf8(buffer.data());
+}
 
-  QString labels;
-  labels += "__time,";
-  for (size_t i = 0; i < plot_count; i++)
+void StatePublisherCSV::saveRangeFile(double time_start, double time_end)
+{
+  const QString csv_filter = tr("CSV files (*.csv)");
+  QString filters = csv_filter;
+#ifdef PJ_PARQUET_EXPORT
+  const QString parquet_filter = tr("Parquet files (*.parquet)");
+  filters += ";;" + parquet_filter;
+#endif
+  QString selected_filter = csv_filter;
+  QString fileName = askSaveFileName(filters, &selected_filter);
+  if (fileName.isEmpty())
   {
-    labels += QString::fromStdString(ordered_plotdata[i].first);
-    labels += (i + 1 < plot_count) ? "," : "\n";
-
-    const PJ::PlotData* plotdata = (ordered_plotdata[i].second);
-    int index = plotdata->getIndexFromX(time_start);
-    if (index < 0)
-    {
-      index = plotdata->size();
-    }
-    indices[i] = index + 1;
+    return;
   }
 
-  bool done = false;
-  QStringList rows = { labels };
+  // the rows are written while they are generated, not collected in memory first
+  QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+  const auto series = seriesInRange(time_start, time_end);
+  QString error;
 
-  while (!done)
+#ifdef PJ_PARQUET_EXPORT
+  if (selected_filter == parquet_filter || fileName.endsWith(".parquet"))
   {
-    // done will become false if at least one plotdata is not completed
-    done = true;
-    double min_time = std::numeric_limits<double>::max();
-
-    for (size_t i = 0; i < plot_count; i++)
+    if (!fileName.endsWith(".parquet"))
     {
-      size_t index = indices[i];
-      const PJ::PlotData* plotdata = (ordered_plotdata[i].second);
-      row_values[i] = NaN;
-
-      if (index >= plotdata->size())
-      {
-        continue;
-      }
-      const auto& point = plotdata->at(index);
-      if (point.x > time_end)
-      {
-        continue;
-      }
-
-      done = false;
-
-      if (min_time > point.x)
-      {
-        min_time = point.x;  // new min_time
-        // reset previous flags
-        std::fill(row_values.begin(), row_values.begin() + i, NaN);
-        row_values[i] = point.y;
-      }
-      else if (std::abs(min_time - point.x) < std::numeric_limits<double>::epsilon())
-      {
-        row_values[i] = point.y;
-      }
+      fileName.append(".parquet");
     }
-
-    if (min_time > time_end || done)
+    std::string parquet_error;
+    if (!WriteRangeParquet(fileName.toStdString(), series, time_start, time_end,
+                           parquet_error))
     {
-      break;
+      error = QString::fromStdString(parquet_error);
     }
-
-    // the row to append to the CSV file
-    QString row_str = QString::number(min_time, 'f', 6) + ",";
-
-    for (size_t i = 0; i < plot_count; i++)
+    QApplication::restoreOverrideCursor();
+    if (!error.isEmpty())
     {
-      if (!std::isnan(row_values[i]))
-      {
-        row_str += QString::number(row_values[i], 'f', 9);
-        // value used, move to the nex index
-        indices[i]++;
-      }
-      row_str += (i + 1 < plot_count) ? "," : "\n";
+      QMessageBox::warning(
+          nullptr, "Error",
+          QString("Failed to write the file [%1]: %2").arg(fileName, error));
     }
-    rows.push_back(row_str);
+    return;
+  }
+#endif
+
+  if (!fileName.endsWith(".csv"))
+  {
+    fileName.append(".csv");
+  }
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly))
+  {
+    error = QString("Failed to open the file [%1]").arg(fileName);
+  }
+  else if (!WriteRangeCSV(file, series, time_start, time_end))
+  {
+    error = QString("Failed to write the file [%1]").arg(fileName);
+  }
+  QApplication::restoreOverrideCursor();
+
+  if (!error.isEmpty())
+  {
+    QMessageBox::warning(nullptr, "Error", error);
   }
-  return rows.join("");
 }
@@ -9,6 +9,7 @@
 #include <mutex>
 #include "ui_publisher_csv_dialog.h"
 #include "PlotJuggler/statepublisher_base.h"
+#include "range_export.h"
 
 class StatePublisherCSV : public PJ::StatePublisher
 {
@@ -61,14 +62,20 @@ private:
 
   void delayedClearNotification();
 
+  std::vector<NamedSeries> seriesInRange(double time_start, double time_end);
+
   QString generateRangeCSV(double time_start, double time_end);
 
+  void saveRangeFile(double time_start, double time_end);
+
   QString generateStatisticsCSV(double time_start, double time_end);
 
   bool getTimeRanges(double* first, double* last);
 
   void updateButtonsState();
 
+  QString askSaveFileName(const QString& filters, QString* selected_filter = nullptr);
+
   void saveFile(QString text);
 };
 
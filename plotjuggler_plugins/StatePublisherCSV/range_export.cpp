@@ -0,0 +1,105 @@
+#include "range_export.h"
+#include <cmath>
+#include <iterator>
+#include "PlotJuggler/fmt/format.h"
+#include "PlotJuggler/util/time_alignment.hpp"
+
+SeriesMerger::SeriesMerger(const std::vector<NamedSeries>& series, double time_start,
+                           double time_end)
+  : _time_end(time_end)
+{
+  const auto NaN = std::numeric_limits<double>::quiet_NaN();
+  for (const auto& it : series)
+  {
+    _series.push_back(it.data);
+    // first point with x >= time_start
+    PJ::TimeseriesCursor cursor(it.data);
+    _indices.push_back(cursor.lowerBound(time_start));
+    _row.push_back(NaN);
+    pushHead(_series.size() - 1);
+  }
+}
+
+void SeriesMerger::pushHead(size_t series)
+{
+  const auto* data = _series[series];
+  const size_t index = _indices[series];
+  if (index < data->size() && data->at(index).x <= _time_end)
+  {
+    _heap.push({ data->at(index).x, series });
+  }
+}
+
+bool SeriesMerger::next()
+{
+  // the series used in the previous row move forward by one point
+  for (size_t series : _used)
+  {
+    _row[series] = std::numeric_limits<double>::quiet_NaN();
+    _indices[series]++;
+    pushHead(series);
+  }
+  _used.clear();
+
+  if (_heap.empty())
+  {
+    return false;
+  }
+  _time = _heap.top().time;
+
+  while (!_heap.empty() &&
+         std::abs(_heap.top().time - _time) < std::numeric_limits<double>::epsilon())
+  {
+    const size_t series = _heap.top().series;
+    _heap.pop();
+    _row[series] = _series[series]->at(_indices[series]).y;
+    _used.push_back(series);
+  }
+  return true;
+}
+
+bool WriteRangeCSV(QIODevice& device, const std::vector<NamedSeries>& series,
+                   double time_start, double time_end)
+{
+  // the text is written in blocks of this size
+  constexpr size_t FLUSH_SIZE = 1024 * 1024;
+
+  fmt::memory_buffer buffer;
+  auto out = std::back_inserter(buffer);
+
+  auto flush = [&]() {
+    const auto size = qint64(buffer.size());
+    const bool ok = (device.write(buffer.data(), size) == size);
+    buffer.clear();
+    return ok;
+  };
+
+  fmt::format_to(out, "__time");
+  for (const auto& it : series)
+  {
+    fmt::format_to(out, ",{}", it.name);
+  }
+  buffer.push_back('\n');
+
+  SeriesMerger merger(series, time_start, time_end);
+  while (merger.next())
+  {
+    fmt::format_to(out, "{:.6f}", merger.time());
+    for (double value : merger.row())
+    {
+      buffer.push_back(',');
+      if (!std::isnan(value))
+      {
+        // shortest representation that reads back to the same value
+        fmt::format_to(out, "{}", value);
+      }
+    }
+    buffer.push_back('\n');
+
+    if (buffer.size() >= FLUSH_SIZE && !flush())
+    {
+      return false;
+    }
+  }
+  return flush();
+}
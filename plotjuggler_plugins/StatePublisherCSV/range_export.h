@@ -0,0 +1,78 @@
+#ifndef RANGE_EXPORT_H
+#define RANGE_EXPORT_H
+
+#include <queue>
+#include <string>
+#include <vector>
+#include <QIODevice>
+#include "PlotJuggler/plotdata.h"
+
+struct NamedSeries
+{
+  std::string name;
+  const PJ::PlotData* data;
+};
+
+/**
+ * @brief Merge many timeseries into rows, one per distinct timestamp, in the range
+ * [time_start, time_end].
+ *
+ * The next point of each series is kept in a min-heap, therefore producing a row
+ * costs O(log N) per value, instead of a scan of all the N series.
+ */
+class SeriesMerger
+{
+public:
+  SeriesMerger(const std::vector<NamedSeries>& series, double time_start,
+               double time_end);
+
+  /// Move to the next timestamp. Returns false when all the points were used.
+  bool next();
+
+  double time() const
+  {
+    return _time;
+  }
+
+  /// Value of each series at time(); NaN if the series has no point there.
+  const std::vector<double>& row() const
+  {
+    return _row;
+  }
+
+private:
+  struct Head
+  {
+    double time;
+    size_t series;
+    bool operator>(const Head& other) const
+    {
+      return time > other.time || (time == other.time && series > other.series);
+    }
+  };
+
+  std::vector<const PJ::PlotData*> _series;
+  std::vector<size_t> _indices;
+  double _time_end;
+  std::priority_queue<Head, std::vector<Head>, std::greater<Head>> _heap;
+  // series whose value was used in the current row
+  std::vector<size_t> _used;
+  std::vector<double> _row;
+  double _time = 0;
+
+  void pushHead(size_t series);
+};
+
+/// Write the series as CSV, one column per series. Returns false if writing failed.
+bool WriteRangeCSV(QIODevice& device, const std::vector<NamedSeries>& series,
+                   double time_start, double time_end);
+
+#ifdef PJ_PARQUET_EXPORT
+/// Write the series as a Parquet file, one optional column per series.
+/// On failure, returns false and sets "error".
+bool WriteRangeParquet(const std::string& filename,
+                       const std::vector<NamedSeries>& series, double time_start,
+                       double time_end, std::string& error);
+#endif
+
+#endif  // RANGE_EXPORT_H
@@ -0,0 +1,63 @@
+#include "range_export.h"
+#include <cmath>
+#include <arrow/io/file.h>
+#include <parquet/stream_writer.h>
+
+bool WriteRangeParquet(const std::string& filename,
+                       const std::vector<NamedSeries>& series, double time_start,
+                       double time_end, std::string& error)
+{
+  using parquet::ConvertedType;
+  using parquet::Repetition;
+  using parquet::Type;
+  using parquet::schema::GroupNode;
+  using parquet::schema::PrimitiveNode;
+
+  auto file = arrow::io::FileOutputStream::Open(filename);
+  if (!file.ok())
+  {
+    error = file.status().ToString();
+    return false;
+  }
+
+  // a series has no value in the rows where it has no point: its column is optional
+  parquet::schema::NodeVector fields;
+  fields.push_back(PrimitiveNode::Make("__time", Repetition::REQUIRED, Type::DOUBLE,
+                                       ConvertedType::NONE));
+  for (const auto& it : series)
+  {
+    fields.push_back(PrimitiveNode::Make(it.name, Repetition::OPTIONAL, Type::DOUBLE,
+                                         ConvertedType::NONE));
+  }
+  auto schema = std::static_pointer_cast<GroupNode>(
+      GroupNode::Make("schema", Repetition::REQUIRED, fields));
+
+  try
+  {
+    parquet::StreamWriter writer{ parquet::ParquetFileWriter::Open(*file, schema) };
+
+    SeriesMerger merger(series, time_start, time_end);
+    while (merger.next())
+    {
+      writer << merger.time();
+      for (double value : merger.row())
+      {
+        if (std::isnan(value))
+        {
+          writer.SkipColumns(1);
+        }
+        else
+        {
+          writer << value;
+        }
+      }
+      writer << parquet::EndRow;
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    error = ex.what();
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,72 @@
+#include "binary_frames.h"
+#include <algorithm>
+#include <cstring>
+
+namespace BinaryFrame
+{
+namespace
+{
+// the frames are little-endian: the byte order of all the supported platforms
+template <typename T>
+uint8_t* Write(uint8_t* ptr, T value)
+{
+  std::memcpy(ptr, &value, sizeof(T));
+  return ptr + sizeof(T);
+}
+
+uint8_t* WriteHeader(std::vector<uint8_t>& out, size_t payload_size, FrameType type,
+                     uint32_t schema_id, uint32_t count)
+{
+  out.resize(HEADER_SIZE + payload_size);
+  uint8_t* ptr = out.data();
+  ptr = Write(ptr, FRAME_MAGIC);
+  ptr = Write(ptr, FRAME_VERSION);
+  ptr = Write(ptr, uint16_t(type));
+  ptr = Write(ptr, schema_id);
+  ptr = Write(ptr, count);
+  return ptr;
+}
+}  // namespace
+
+void EncodeSchema(uint32_t schema_id, const std::vector<std::string>& names,
+                  std::vector<uint8_t>& out)
+{
+  size_t payload_size = 0;
+  for (const auto& name : names)
+  {
+    payload_size += sizeof(uint16_t) + std::min<size_t>(name.size(), UINT16_MAX);
+  }
+
+  uint8_t* ptr = WriteHeader(out, payload_size, SCHEMA, schema_id, names.size());
+  for (const auto& name : names)
+  {
+    const uint16_t length = uint16_t(std::min<size_t>(name.size(), UINT16_MAX));
+    ptr = Write(ptr, length);
+    std::memcpy(ptr, name.data(), length);
+    ptr += length;
+  }
+}
+
+void EncodeState(uint32_t schema_id, double time, const std::vector<double>& values,
+                 std::vector<uint8_t>& out)
+{
+  const size_t payload_size = sizeof(double) * (1 + values.size());
+  uint8_t* ptr = WriteHeader(out, payload_size, STATE, schema_id, values.size());
+  ptr = Write(ptr, time);
+  std::memcpy(ptr, values.data(), sizeof(double) * values.size());
+}
+
+void EncodeSamples(uint32_t schema_id, const std::vector<Sample>& samples,
+                   std::vector<uint8_t>& out)
+{
+  constexpr size_t SAMPLE_SIZE = sizeof(uint32_t) + 2 * sizeof(double);
+  uint8_t* ptr =
+      WriteHeader(out, SAMPLE_SIZE * samples.size(), SAMPLES, schema_id, samples.size());
+  for (const auto& sample : samples)
+  {
+    ptr = Write(ptr, sample.index);
+    ptr = Write(ptr, sample.time);
+    ptr = Write(ptr, sample.value);
+  }
+}
+}  // namespace BinaryFrame
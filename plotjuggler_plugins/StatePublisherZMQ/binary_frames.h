@@ -0,0 +1,59 @@
+#ifndef BINARY_FRAMES_H
+#define BINARY_FRAMES_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Compact binary frames published by StatePublisherZMQ.
+ *
+ * All the numbers are little-endian, without padding. Each frame starts with:
+ *
+ *   uint32  magic       FRAME_MAGIC
+ *   uint16  version     FRAME_VERSION
+ *   uint16  type        FrameType
+ *   uint32  schema_id   incremented every time the list of series changes
+ *   uint32  count       number of entries that follow
+ *
+ * SCHEMA:   count x { uint16 length; char name[length] }, UTF-8 names of the
+ *           series. The position of a name in this list is the index of the series.
+ * STATE:    double time, then count x double: value of each series at that time,
+ *           NaN if the series has no point before it.
+ * SAMPLES:  count x { uint32 index; double time; double value }, sorted by time.
+ *
+ * STATE and SAMPLES frames can be decoded only with the SCHEMA frame that has the
+ * same schema_id; it is sent again periodically.
+ */
+namespace BinaryFrame
+{
+constexpr uint32_t FRAME_MAGIC = 0x46424A50;  // "PJBF"
+constexpr uint16_t FRAME_VERSION = 1;
+constexpr size_t HEADER_SIZE = 16;
+
+enum FrameType : uint16_t
+{
+  SCHEMA = 1,
+  STATE = 2,
+  SAMPLES = 3
+};
+
+struct Sample
+{
+  uint32_t index;
+  double time;
+  double value;
+};
+
+/// The previous content of "out" is replaced; its capacity is reused.
+void EncodeSchema(uint32_t schema_id, const std::vector<std::string>& names,
+                  std::vector<uint8_t>& out);
+
+void EncodeState(uint32_t schema_id, double time, const std::vector<double>& values,
+                 std::vector<uint8_t>& out);
+
+void EncodeSamples(uint32_t schema_id, const std::vector<Sample>& samples,
+                   std::vector<uint8_t>& out);
+}  // namespace BinaryFrame
+
+#endif  // BINARY_FRAMES_H
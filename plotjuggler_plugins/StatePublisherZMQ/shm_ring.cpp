@@ -0,0 +1,152 @@
+#include "shm_ring.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "the offsets are shared with other processes");
+
+namespace
+{
+constexpr uint64_t RECORD_ALIGNMENT = 8;
+
+uint64_t AlignedSize(uint64_t size)
+{
+  return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+}  // namespace
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+  close();
+}
+
+#ifdef _WIN32
+
+bool SharedMemoryRing::open(const std::string&, size_t, std::string& error)
+{
+  error = "Shared memory is supported only on Linux and macOS";
+  return false;
+}
+
+void SharedMemoryRing::close()
+{
+}
+
+#else
+
+bool SharedMemoryRing::open(const std::string& name, size_t capacity,
+                            std::string& error)
+{
+  close();
+
+  // the data area is a multiple of the alignment, therefore records never
+  // start in the last few bytes of the area
+  capacity = AlignedSize(capacity);
+  if (capacity == 0)
+  {
+    error = "The size of the shared memory can't be zero";
+    return false;
+  }
+
+  // readers that have the old object mapped keep it; new ones will see this one
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0)
+  {
+    error = std::string("shm_open failed: ") + std::strerror(errno);
+    return false;
+  }
+
+  const size_t mapped_size = sizeof(RingHeader) + capacity;
+  if (ftruncate(fd, off_t(mapped_size)) != 0)
+  {
+    error = std::string("ftruncate failed: ") + std::strerror(errno);
+    ::close(fd);
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  void* ptr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (ptr == MAP_FAILED)
+  {
+    error = std::string("mmap failed: ") + std::strerror(errno);
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  _name = name;
+  _mapped_size = mapped_size;
+  _header = new (ptr) RingHeader();
+  _data = static_cast<uint8_t*>(ptr) + sizeof(RingHeader);
+
+  _header->version = RING_VERSION;
+  _header->capacity = capacity;
+  _header->write_offset.store(0, std::memory_order_relaxed);
+  _header->reserve_offset.store(0, std::memory_order_relaxed);
+  // the magic number is written last: readers check it before anything else
+  std::atomic_thread_fence(std::memory_order_release);
+  _header->magic = RING_MAGIC;
+  return true;
+}
+
+void SharedMemoryRing::close()
+{
+  if (!_header)
+  {
+    return;
+  }
+  munmap(_header, _mapped_size);
+  shm_unlink(_name.c_str());
+  _header = nullptr;
+  _data = nullptr;
+  _mapped_size = 0;
+  _name.clear();
+}
+
+#endif
+
+void SharedMemoryRing::copyToRing(uint64_t offset, const uint8_t* data, size_t size)
+{
+  const uint64_t capacity = _header->capacity;
+  const size_t pos = size_t(offset % capacity);
+  const size_t first_part = std::min<size_t>(size, capacity - pos);
+  std::memcpy(_data + pos, data, first_part);
+  std::memcpy(_data, data + first_part, size - first_part);
+}
+
+void SharedMemoryRing::write(const uint8_t* data, size_t size)
+{
+  if (!_header)
+  {
+    return;
+  }
+  const uint64_t record_size = AlignedSize(sizeof(uint32_t) + size);
+  if (size > UINT32_MAX || record_size > _header->capacity)
+  {
+    return;
+  }
+
+  // single producer: nobody else modifies the offsets
+  const uint64_t offset = _header->write_offset.load(std::memory_order_relaxed);
+  const uint64_t end_offset = offset + record_size;
+
+  // publish the reservation before touching the data: a consumer that reads any
+  // byte of this record, and then the reserve_offset, sees the new value
+  _header->reserve_offset.store(end_offset, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const uint32_t length = uint32_t(size);
+  copyToRing(offset, reinterpret_cast<const uint8_t*>(&length), sizeof(length));
+  copyToRing(offset + sizeof(length), data, size);
+
+  _header->write_offset.store(end_offset, std::memory_order_release);
+}
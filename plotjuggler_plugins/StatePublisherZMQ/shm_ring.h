@@ -0,0 +1,77 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Ring buffer of variable size records in POSIX shared memory, written by
+ * a single producer and read by any number of consumers on the same host.
+ *
+ * Layout of the shared memory object:
+ *
+ *   RingHeader (64 bytes), then "capacity" bytes of data.
+ *
+ * Each record is a uint32 length followed by the payload, and starts at an offset
+ * multiple of 8. Offsets grow forever: the position in the data area is
+ * (offset % capacity), therefore a record may continue at the beginning of the
+ * data area. Before copying a record, the producer moves reserve_offset to its
+ * end; write_offset reaches the same value after the record is complete.
+ *
+ * A consumer keeps its own read offset, starting from write_offset, and reads the
+ * records before write_offset. After copying a record, it must issue an acquire
+ * fence and check that (reserve_offset - read offset) is not larger than
+ * capacity; otherwise the producer was overwriting the record meanwhile and the
+ * consumer must start again from the current write_offset.
+ */
+class SharedMemoryRing
+{
+public:
+  static constexpr uint32_t RING_MAGIC = 0x52424A50;  // "PJBR"
+  static constexpr uint32_t RING_VERSION = 2;
+
+  struct RingHeader
+  {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    std::atomic<uint64_t> write_offset;
+    std::atomic<uint64_t> reserve_offset;
+    uint64_t reserved[4];
+  };
+  static_assert(sizeof(RingHeader) == 64, "the header is part of the protocol");
+
+  SharedMemoryRing() = default;
+
+  SharedMemoryRing(const SharedMemoryRing&) = delete;
+  SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+  ~SharedMemoryRing();
+
+  /// Create the shared memory object, replacing an existing one with the same name.
+  /// On failure, returns false and sets "error".
+  bool open(const std::string& name, size_t capacity, std::string& error);
+
+  /// Unmap and remove the shared memory object.
+  void close();
+
+  bool isOpen() const
+  {
+    return _header != nullptr;
+  }
+
+  /// Append a record, overwriting the oldest ones. Records larger than the
+  /// capacity are dropped.
+  void write(const uint8_t* data, size_t size);
+
+private:
+  std::string _name;
+  size_t _mapped_size = 0;
+  RingHeader* _header = nullptr;
+  uint8_t* _data = nullptr;
+
+  void copyToRing(uint64_t offset, const uint8_t* data, size_t size);
+};
+
+#endif  // SHM_RING_H
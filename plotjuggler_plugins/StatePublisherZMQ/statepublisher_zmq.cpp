@@ -1,123 +1,253 @@
 #include "statepublisher_zmq.h"
-#include <QTextStream>
-#include <QFile>
+#include "ui_statepublisher_zmq.h"
+
+#include <QDialog>
 #include <QMessageBox>
-#include <zmq.hpp>
-#include <thread>
+#include <QSettings>
+#include <algorithm>
+#include <cstring>
+
+using namespace PJ;
 
 StatePublisherZMQ::StatePublisherZMQ()
-  : _prev_dataplot(0)
-  , _thread(std::bind(&StatePublisherZMQ::run_thread, this))
-  , _prev_time(0)
 {
 }
 
 StatePublisherZMQ::~StatePublisherZMQ()
 {
+  stop();
 }
 
-void StatePublisherZMQ::run_thread()
+void StatePublisherZMQ::setEnabled(bool enabled)
 {
-  zmq::context_t context(1);
-  zmq::socket_t socket(context, ZMQ_REP);
-  socket.bind("tcp://*:6665");
+  if (enabled == _enabled)
+  {
+    return;
+  }
+  if (!enabled)
+  {
+    stop();
+    return;
+  }
+  _enabled = start();
+  if (!_enabled)
+  {
+    emit closed();
+  }
+}
 
-  while (true)
+bool StatePublisherZMQ::start()
+{
+  QDialog dialog;
+  Ui::PublisherZMQ_Dialog ui;
+  ui.setupUi(&dialog);
+
+  // load previous values
+  QSettings settings;
+  QString endpoint = settings.value("ZMQ_Publisher::endpoint", "tcp://*:9873").toString();
+  int mode = settings.value("ZMQ_Publisher::mode", int(STATE)).toInt();
+  bool use_shm = settings.value("ZMQ_Publisher::shared_memory", false).toBool();
+  QString shm_name =
+      settings.value("ZMQ_Publisher::shm_name", "/plotjuggler_state").toString();
+  int shm_size_mb = settings.value("ZMQ_Publisher::shm_size_mb", 16).toInt();
+
+  ui.lineEditEndpoint->setText(endpoint);
+  ui.comboBoxMode->setCurrentIndex(mode);
+  ui.lineEditShmName->setText(shm_name);
+  ui.spinBoxShmSize->setValue(shm_size_mb);
+  ui.checkBoxSharedMemory->setChecked(use_shm);
+  ui.lineEditShmName->setEnabled(use_shm);
+  ui.spinBoxShmSize->setEnabled(use_shm);
+
+  connect(ui.checkBoxSharedMemory, &QCheckBox::toggled, &dialog, [&ui](bool checked) {
+    ui.lineEditShmName->setEnabled(checked);
+    ui.spinBoxShmSize->setEnabled(checked);
+  });
+
+  if (dialog.exec() == QDialog::Rejected)
   {
-    zmq::message_t request;
+    return false;
+  }
 
-    //  Wait for next request from client
-    socket.recv(&request);
-    const char* request_data = (const char*)request.data();
+  endpoint = ui.lineEditEndpoint->text();
+  mode = ui.comboBoxMode->currentIndex();
+  use_shm = ui.checkBoxSharedMemory->isChecked();
+  shm_name = ui.lineEditShmName->text();
+  shm_size_mb = ui.spinBoxShmSize->value();
 
-    if (strncmp(request_data, "[get_data_names]", 16) == 0)
-    {
-      QString string_reply;
+  // save back to service
+  settings.setValue("ZMQ_Publisher::endpoint", endpoint);
+  settings.setValue("ZMQ_Publisher::mode", mode);
+  settings.setValue("ZMQ_Publisher::shared_memory", use_shm);
+  settings.setValue("ZMQ_Publisher::shm_name", shm_name);
+  settings.setValue("ZMQ_Publisher::shm_size_mb", shm_size_mb);
 
-      _mutex.lock();
+  _mode = (mode == SAMPLES) ? SAMPLES : STATE;
 
-      std::map<QString, double>::iterator it;
-      for (it = _current_data.begin(); it != _current_data.end(); it++)
-      {
-        string_reply.append(it->first + QString(" "));
-      }
-      _mutex.unlock();
+  try
+  {
+    _zmq_socket = std::make_unique<zmq::socket_t>(_zmq_context, zmq::socket_type::pub);
+    _zmq_socket->set(zmq::sockopt::linger, 0);
+    _zmq_socket->bind(endpoint.toStdString());
+  }
+  catch (zmq::error_t& err)
+  {
+    _zmq_socket.reset();
+    QMessageBox::warning(nullptr, tr("ZMQ Publisher"),
+                         tr("Can't bind to [%1]: %2").arg(endpoint).arg(err.what()),
+                         QMessageBox::Ok);
+    return false;
+  }
 
-      zmq::message_t reply(string_reply.size());
-      socket.send(reply);
-    }
-    else if (strncmp(request_data, "[get_data]", 10) == 0)
+  if (use_shm)
+  {
+    std::string error;
+    const size_t capacity = size_t(shm_size_mb) * 1024 * 1024;
+    if (!_shm_ring.open(shm_name.toStdString(), capacity, error))
     {
-      bool abort = false;
-      QString string_request = QString::fromUtf8(&request_data[10], request.size() - 10);
-      QStringList names = string_request.split(';');
+      stop();
+      QMessageBox::warning(nullptr, tr("ZMQ Publisher"),
+                           tr("Can't create the shared memory [%1]: %2")
+                               .arg(shm_name)
+                               .arg(QString::fromStdString(error)),
+                           QMessageBox::Ok);
+      return false;
+    }
+  }
 
-      _mutex.lock();
-      QString string_reply;
+  // force a new schema
+  _names.clear();
+  _cursors.clear();
+  _schema_timer.invalidate();
+  _previous_time = std::numeric_limits<double>::quiet_NaN();
+  return true;
+}
 
-      for (int i = 0; i < names.count(); i++)
-      {
-        std::map<QString, double>::iterator it = _current_data.find(names.at(i));
-        if (it == _current_data.end())
-        {
-          abort = true;
-          break;
-        }
-        else
-        {
-          double value = it->second;
-          string_reply.append(QString::number(value) + QString(" "));
-        }
-      }
-      _mutex.unlock();
+void StatePublisherZMQ::stop()
+{
+  _enabled = false;
+  _zmq_socket.reset();
+  _shm_ring.close();
+}
 
-      if (abort)
-      {
-        zmq::message_t reply(5);
-        memcpy(reply.data(), "Error", 5);
-        socket.send(reply);
-      }
-      else
+void StatePublisherZMQ::updateState(double current_time)
+{
+  if (!_enabled)
+  {
+    return;
+  }
+  publishState(current_time);
+  _previous_time = current_time;
+}
+
+void StatePublisherZMQ::play(double current_time)
+{
+  if (!_enabled)
+  {
+    return;
+  }
+  // when the playback loops, the time goes backward: send the state instead
+  if (_mode == SAMPLES && current_time >= _previous_time)
+  {
+    publishSamples(_previous_time, current_time);
+  }
+  else
+  {
+    publishState(current_time);
+  }
+  _previous_time = current_time;
+}
+
+void StatePublisherZMQ::updateSchema()
+{
+  // compare the names: a node of the map may be freed and reused by another
+  // series. When nothing changed, the cursors are just bound to the series again
+  bool changed = (_names.size() != _datamap->numeric.size());
+  if (!changed)
+  {
+    size_t index = 0;
+    for (const auto& it : _datamap->numeric)
+    {
+      if (_names[index] != it.first)
       {
-        zmq::message_t reply(string_reply.size());
-        socket.send(reply);
+        changed = true;
+        break;
       }
+      _cursors[index++].setSeries(&it.second);
     }
-    else
+  }
+
+  if (changed)
+  {
+    _names.clear();
+    _cursors.clear();
+    for (const auto& it : _datamap->numeric)
     {
-      zmq::message_t reply(5);
-      memcpy(reply.data(), "Error", 5);
-      socket.send(reply);
+      _names.push_back(it.first);
+      _cursors.emplace_back(&it.second);
     }
+    _schema_id++;
+  }
+
+  if (changed || !_schema_timer.isValid() || _schema_timer.elapsed() >= SCHEMA_PERIOD_MS)
+  {
+    BinaryFrame::EncodeSchema(_schema_id, _names, _buffer);
+    send("schema");
+    _schema_timer.start();
   }
 }
 
-void StatePublisherZMQ::updateState(PlotDataMap* datamap, double current_time)
+void StatePublisherZMQ::publishState(double time)
 {
-  if (datamap == 0)
+  updateSchema();
+
+  _values.resize(_cursors.size());
+  for (size_t i = 0; i < _cursors.size(); i++)
   {
-    _prev_dataplot = datamap;
-    _prev_time = current_time;
-    _mutex.lock();
-    _current_data.clear();
-    _mutex.unlock();
-    return;
+    auto value = _cursors[i].valueAt(time, AlignmentPolicy::PREVIOUS);
+    _values[i] = value ? *value : std::numeric_limits<double>::quiet_NaN();
   }
+  BinaryFrame::EncodeState(_schema_id, time, _values, _buffer);
+  send("state");
+}
 
-  PlotDataMap::iterator it;
+void StatePublisherZMQ::publishSamples(double start_time, double end_time)
+{
+  updateSchema();
 
-  _mutex.lock();
-  if (datamap != _prev_dataplot || current_time != _prev_time)
+  // points in the interval (start_time, end_time]
+  _samples.clear();
+  for (size_t i = 0; i < _cursors.size(); i++)
   {
-    for (it = datamap->begin(); it != datamap->end(); it++)
+    auto& cursor = _cursors[i];
+    const size_t first = cursor.upperBound(start_time);
+    const size_t last = cursor.upperBound(end_time);
+    for (size_t index = first; index < last; index++)
     {
-      const QString& name = it->first;
-      PlotDataPtr Timeseries = it->second;
-      _current_data[name] = plotdata->getY(current_time);
+      const auto& point = cursor.series()->at(index);
+      _samples.push_back({ uint32_t(i), point.x, point.y });
     }
   }
-  _mutex.unlock();
+  if (_samples.empty())
+  {
+    return;
+  }
+  std::stable_sort(_samples.begin(), _samples.end(),
+                   [](const BinaryFrame::Sample& a, const BinaryFrame::Sample& b) {
+                     return a.time < b.time;
+                   });
+  BinaryFrame::EncodeSamples(_schema_id, _samples, _buffer);
+  send("samples");
+}
 
-  _prev_dataplot = datamap;
-  _prev_time = current_time;
+void StatePublisherZMQ::send(const char* topic)
+{
+  if (_zmq_socket)
+  {
+    // a PUB socket drops the messages when a subscriber is too slow
+    _zmq_socket->send(zmq::buffer(topic, std::strlen(topic)),
+                      zmq::send_flags::sndmore | zmq::send_flags::dontwait);
+    _zmq_socket->send(zmq::buffer(_buffer), zmq::send_flags::dontwait);
+  }
+  _shm_ring.write(_buffer.data(), _buffer.size());
 }
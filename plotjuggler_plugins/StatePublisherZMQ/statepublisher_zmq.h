@@ -3,34 +3,93 @@
 
 #include <QObject>
 #include <QtPlugin>
-#include <zmq.hpp>
-#include <thread>
-#include <mutex>
-#include "../statepublisher_base.h"
+#include <QElapsedTimer>
+#include <limits>
+#include <memory>
+#include "DataStreamZMQ/zmq.hpp"
+#include "PlotJuggler/statepublisher_base.h"
+#include "PlotJuggler/util/time_alignment.hpp"
+#include "binary_frames.h"
+#include "shm_ring.h"
 
-class StatePublisherZMQ : public QObject, StatePublisher
+/**
+ * @brief Publish the numeric series with a ZMQ PUB socket, using the compact
+ * frames described in binary_frames.h, and optionally in a shared memory ring
+ * (see SharedMemoryRing) for consumers on the same host.
+ *
+ * Each message has two parts: the topic ("schema", "state" or "samples") and the
+ * frame. In STATE mode, the value of every series at the time tracker is sent.
+ * In SAMPLES mode, during playback, all the points between two consecutive calls
+ * of play() are sent instead, to keep the original rate of the data.
+ */
+class StatePublisherZMQ : public PJ::StatePublisher
 {
   Q_OBJECT
   Q_PLUGIN_METADATA(IID "facontidavide.PlotJuggler3.StatePublisher")
   Q_INTERFACES(PJ::StatePublisher)
 
 public:
+  enum Mode
+  {
+    STATE = 0,
+    SAMPLES = 1
+  };
+
   StatePublisherZMQ();
 
-  virtual void updateState(PlotDataMap* datamap, double current_time);
+  virtual ~StatePublisherZMQ() override;
+
+  virtual const char* name() const override
+  {
+    return "ZMQ Publisher";
+  }
+
+  virtual bool enabled() const override
+  {
+    return _enabled;
+  }
+
+  virtual void updateState(double current_time) override;
 
-  virtual ~StatePublisherZMQ();
+  virtual void play(double current_time) override;
+
+public slots:
+  virtual void setEnabled(bool enabled) override;
 
 private:
-  PlotDataMap* _prev_dataplot;
+  // the schema is sent again periodically, for the subscribers that connect late
+  static constexpr int SCHEMA_PERIOD_MS = 1000;
+
+  bool _enabled = false;
+  Mode _mode = STATE;
+
+  zmq::context_t _zmq_context;
+  std::unique_ptr<zmq::socket_t> _zmq_socket;
+  SharedMemoryRing _shm_ring;
+
+  std::vector<std::string> _names;
+  std::vector<PJ::TimeseriesCursor> _cursors;
+  uint32_t _schema_id = 0;
+  QElapsedTimer _schema_timer;
+
+  double _previous_time = std::numeric_limits<double>::quiet_NaN();
+
+  // reused by every message, to avoid allocations
+  std::vector<double> _values;
+  std::vector<BinaryFrame::Sample> _samples;
+  std::vector<uint8_t> _buffer;
+
+  bool start();
+
+  void stop();
+
+  void updateSchema();
 
-  void run_thread();
+  void publishState(double time);
 
-  std::thread _thread;
-  std::mutex _mutex;
+  void publishSamples(double start_time, double end_time);
 
-  std::map<QString, double> _current_data;
-  double _prev_time;
+  void send(const char* topic);
 };
 
 #endif  // STATE_PUBLISHER_ZMQ_H
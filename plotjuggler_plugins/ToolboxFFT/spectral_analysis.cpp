@@ -0,0 +1,294 @@
+#include "spectral_analysis.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+
+namespace Spectral
+{
+UniformSignal Resample(const PJ::PlotData& data, size_t first, size_t last)
+{
+  UniformSignal signal;
+  if (last <= first || last >= data.size())
+  {
+    return signal;
+  }
+  const size_t N = last - first + 1;
+  signal.t0 = data[first].x;
+  signal.dt = (data[last].x - data[first].x) / double(N - 1);
+  signal.values.resize(N);
+
+  size_t index = first;
+  for (size_t k = 0; k < N; k++)
+  {
+    const double t = signal.t0 + double(k) * signal.dt;
+    while (index + 1 < last && data[index + 1].x <= t)
+    {
+      index++;
+    }
+    const auto& p0 = data[index];
+    const auto& p1 = data[index + 1];
+    const double span = p1.x - p0.x;
+    if (span <= 0)
+    {
+      signal.values[k] = p0.y;
+    }
+    else
+    {
+      const double ratio = std::min(std::max((t - p0.x) / span, 0.0), 1.0);
+      signal.values[k] = p0.y + ratio * (p1.y - p0.y);
+    }
+  }
+  return signal;
+}
+
+void RemoveAverage(UniformSignal& signal)
+{
+  if (signal.values.empty())
+  {
+    return;
+  }
+  const auto& values = signal.values;
+  const double average =
+      std::accumulate(values.begin(), values.end(), 0.0) / double(values.size());
+  for (auto& value : signal.values)
+  {
+    value -= average;
+  }
+}
+
+//---------------------------------------------------------
+
+FFTPlanCache& FFTPlanCache::instance()
+{
+  static FFTPlanCache cache;
+  return cache;
+}
+
+FFTPlanCache::~FFTPlanCache()
+{
+  for (auto& entry : _free_plans)
+  {
+    for (auto cfg : entry.plans)
+    {
+      free(cfg);
+    }
+  }
+}
+
+std::unique_ptr<FFTPlanCache::Plan> FFTPlanCache::acquire(int nfft)
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = std::find_if(_free_plans.begin(), _free_plans.end(),
+                           [nfft](const FreePlans& entry) { return entry.nfft == nfft; });
+    if (it != _free_plans.end())
+    {
+      // move it to the front, as most recently used
+      std::rotate(_free_plans.begin(), it, it + 1);
+      auto& plans = _free_plans.front().plans;
+      if (!plans.empty())
+      {
+        auto cfg = plans.back();
+        plans.pop_back();
+        return std::make_unique<Plan>(this, nfft, cfg);
+      }
+    }
+  }
+  auto cfg = kiss_fftr_alloc(nfft, false, nullptr, nullptr);
+  return std::make_unique<Plan>(this, nfft, cfg);
+}
+
+std::unique_ptr<FFTPlanCache::Plan> FFTPlanCache::temporary(int nfft)
+{
+  auto cfg = kiss_fftr_alloc(nfft, false, nullptr, nullptr);
+  return std::make_unique<Plan>(nullptr, nfft, cfg);
+}
+
+void FFTPlanCache::release(int nfft, kiss_fftr_cfg cfg)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = std::find_if(_free_plans.begin(), _free_plans.end(),
+                         [nfft](const FreePlans& entry) { return entry.nfft == nfft; });
+  if (it == _free_plans.end())
+  {
+    // the size was evicted while the plan was in use, or never cached
+    _free_plans.insert(_free_plans.begin(), FreePlans{ nfft, {} });
+    it = _free_plans.begin();
+    if (_free_plans.size() > MAX_SIZES)
+    {
+      for (auto old_cfg : _free_plans.back().plans)
+      {
+        free(old_cfg);
+      }
+      _free_plans.pop_back();
+    }
+  }
+  if (it->plans.size() < MAX_PLANS_PER_SIZE)
+  {
+    it->plans.push_back(cfg);
+  }
+  else
+  {
+    free(cfg);
+  }
+}
+
+//---------------------------------------------------------
+
+namespace
+{
+std::vector<double> HannWindow(size_t size)
+{
+  std::vector<double> window(size);
+  for (size_t i = 0; i < size; i++)
+  {
+    window[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * double(i) / double(size));
+  }
+  return window;
+}
+
+// segment size that is even and not larger than the signal
+size_t ValidSegmentSize(size_t segment_size, size_t signal_size)
+{
+  size_t size = std::min(segment_size, signal_size);
+  return size & ~size_t(1);
+}
+
+// Add to "psd" the one-sided periodogram of the segment starting at "offset".
+void AccumulatePeriodogram(const FFTPlanCache::Plan& plan, const UniformSignal& signal,
+                           size_t offset, const std::vector<double>& window,
+                           double scale, std::vector<kiss_fft_scalar>& input,
+                           std::vector<kiss_fft_cpx>& output, double* psd)
+{
+  const size_t size = window.size();
+  for (size_t i = 0; i < size; i++)
+  {
+    input[i] = static_cast<kiss_fft_scalar>(signal.values[offset + i] * window[i]);
+  }
+  plan.forward(input.data(), output.data());
+
+  const size_t bins = size / 2 + 1;
+  for (size_t i = 0; i < bins; i++)
+  {
+    const double re = output[i].r;
+    const double im = output[i].i;
+    double power = re * re + im * im;
+    // energy of the negative frequencies, except DC and Nyquist
+    if (i != 0 && i != bins - 1)
+    {
+      power *= 2.0;
+    }
+    psd[i] += power * scale;
+  }
+}
+}  // namespace
+
+Spectrum AmplitudeSpectrum(const UniformSignal& signal)
+{
+  Spectrum spectrum;
+  const size_t N = ValidSegmentSize(signal.values.size(), signal.values.size());
+  if (N < 8 || signal.dt <= 0)
+  {
+    return spectrum;
+  }
+  std::vector<kiss_fft_scalar> input(signal.values.begin(), signal.values.begin() + N);
+  std::vector<kiss_fft_cpx> output(N / 2 + 1);
+
+  // the size depends on the selected range: don't keep the plan
+  auto plan = FFTPlanCache::temporary(int(N));
+  plan->forward(input.data(), output.data());
+
+  spectrum.frequency.resize(N / 2);
+  spectrum.value.resize(N / 2);
+  for (size_t i = 0; i < N / 2; i++)
+  {
+    spectrum.frequency[i] = double(i) / (signal.dt * double(N));
+    spectrum.value[i] = std::hypot(output[i].r, output[i].i) / double(N);
+  }
+  return spectrum;
+}
+
+Spectrum WelchPSD(const UniformSignal& signal, size_t segment_size)
+{
+  Spectrum spectrum;
+  const size_t size = ValidSegmentSize(segment_size, signal.values.size());
+  if (size < 8 || signal.dt <= 0)
+  {
+    return spectrum;
+  }
+  const auto window = HannWindow(size);
+  double window_power = 0;
+  for (double w : window)
+  {
+    window_power += w * w;
+  }
+  const double scale = signal.dt / window_power;
+
+  const size_t bins = size / 2 + 1;
+  const size_t hop = size / 2;
+  std::vector<double> psd(bins, 0.0);
+  std::vector<kiss_fft_scalar> input(size);
+  std::vector<kiss_fft_cpx> output(bins);
+
+  auto plan = FFTPlanCache::instance().acquire(int(size));
+  size_t segments = 0;
+  for (size_t offset = 0; offset + size <= signal.values.size(); offset += hop)
+  {
+    AccumulatePeriodogram(*plan, signal, offset, window, scale, input, output,
+                          psd.data());
+    segments++;
+  }
+
+  spectrum.frequency.resize(bins);
+  spectrum.value.resize(bins);
+  for (size_t i = 0; i < bins; i++)
+  {
+    spectrum.frequency[i] = double(i) / (signal.dt * double(size));
+    spectrum.value[i] = psd[i] / double(segments);
+  }
+  return spectrum;
+}
+
+Spectrogram ComputeSpectrogram(const UniformSignal& signal, size_t segment_size)
+{
+  Spectrogram spectrogram;
+  const size_t size = ValidSegmentSize(segment_size, signal.values.size());
+  if (size < 8 || signal.dt <= 0)
+  {
+    return spectrogram;
+  }
+  const auto window = HannWindow(size);
+  double window_power = 0;
+  for (double w : window)
+  {
+    window_power += w * w;
+  }
+  const double scale = signal.dt / window_power;
+
+  const size_t hop = size / 2;
+  spectrogram.bins = size / 2 + 1;
+  spectrogram.frames = 1 + (signal.values.size() - size) / hop;
+  spectrogram.t0 = signal.t0 + signal.dt * double(size) / 2.0;
+  spectrogram.time_step = signal.dt * double(hop);
+  spectrogram.frequency_step = 1.0 / (signal.dt * double(size));
+  spectrogram.power_db.assign(spectrogram.frames * spectrogram.bins, 0.0);
+
+  std::vector<kiss_fft_scalar> input(size);
+  std::vector<kiss_fft_cpx> output(spectrogram.bins);
+  auto plan = FFTPlanCache::instance().acquire(int(size));
+
+  for (size_t frame = 0; frame < spectrogram.frames; frame++)
+  {
+    double* row = &spectrogram.power_db[frame * spectrogram.bins];
+    AccumulatePeriodogram(*plan, signal, frame * hop, window, scale, input, output, row);
+    for (size_t i = 0; i < spectrogram.bins; i++)
+    {
+      // avoid log10(0)
+      row[i] = 10.0 * std::log10(std::max(row[i], 1e-30));
+    }
+  }
+  return spectrogram;
+}
+
+}  // namespace Spectral
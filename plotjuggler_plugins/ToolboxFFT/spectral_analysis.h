@@ -0,0 +1,136 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "PlotJuggler/plotdata.h"
+#include "KissFFT/kiss_fftr.h"
+
+namespace Spectral
+{
+/// Signal sampled with a constant period.
+struct UniformSignal
+{
+  double t0 = 0;
+  double dt = 0;
+  std::vector<double> values;
+};
+
+/**
+ * @brief Resample the points in the range [first, last] of "data" with a constant
+ * period (the average one), using linear interpolation. Unlike using the samples
+ * as they are, the timing jitter does not distort the spectrum.
+ */
+UniformSignal Resample(const PJ::PlotData& data, size_t first, size_t last);
+
+/// Subtract the average value.
+void RemoveAverage(UniformSignal& signal);
+
+/**
+ * @brief Plans of the real FFT, cached by size.
+ *
+ * A kiss_fftr plan contains a scratch buffer, therefore it can't be used by two
+ * threads at the same time. acquire() lends a plan exclusively, allocating it
+ * only if all the plans of that size are in use.
+ *
+ * Only the MAX_SIZES sizes used most recently are kept, with at most
+ * MAX_PLANS_PER_SIZE plans each. Sizes that are unlikely to be used again,
+ * such as the length of a whole signal, should use temporary() instead.
+ */
+class FFTPlanCache
+{
+public:
+  class Plan
+  {
+  public:
+    // if cache is null, the plan is freed when destroyed
+    Plan(FFTPlanCache* cache, int nfft, kiss_fftr_cfg cfg)
+      : _cache(cache), _nfft(nfft), _cfg(cfg)
+    {
+    }
+    Plan(const Plan&) = delete;
+    Plan& operator=(const Plan&) = delete;
+
+    ~Plan()
+    {
+      if (_cache)
+      {
+        _cache->release(_nfft, _cfg);
+      }
+      else
+      {
+        free(_cfg);
+      }
+    }
+
+    /// "out" must have nfft/2 + 1 elements.
+    void forward(const kiss_fft_scalar* in, kiss_fft_cpx* out) const
+    {
+      kiss_fftr(_cfg, in, out);
+    }
+
+  private:
+    FFTPlanCache* _cache;
+    int _nfft;
+    kiss_fftr_cfg _cfg;
+  };
+
+  static constexpr size_t MAX_SIZES = 4;
+  static constexpr size_t MAX_PLANS_PER_SIZE = 8;
+
+  static FFTPlanCache& instance();
+
+  ~FFTPlanCache();
+
+  /// nfft must be even.
+  std::unique_ptr<Plan> acquire(int nfft);
+
+  /// Plan that is not cached. nfft must be even.
+  static std::unique_ptr<Plan> temporary(int nfft);
+
+private:
+  void release(int nfft, kiss_fftr_cfg cfg);
+
+  struct FreePlans
+  {
+    int nfft;
+    std::vector<kiss_fftr_cfg> plans;
+  };
+
+  std::mutex _mutex;
+  // sorted from the most recently used size
+  std::vector<FreePlans> _free_plans;
+};
+
+struct Spectrum
+{
+  std::vector<double> frequency;
+  std::vector<double> value;
+};
+
+/// Amplitude of the FFT of the entire signal.
+Spectrum AmplitudeSpectrum(const UniformSignal& signal);
+
+/**
+ * @brief Power spectral density, estimated with the Welch method: average of the
+ * periodograms of segments with a Hann window and 50% overlap.
+ * The unit is [value^2 / Hz].
+ */
+Spectrum WelchPSD(const UniformSignal& signal, size_t segment_size);
+
+struct Spectrogram
+{
+  // time of the center of the first segment
+  double t0 = 0;
+  double time_step = 0;
+  double frequency_step = 0;
+  size_t frames = 0;
+  size_t bins = 0;
+  // power spectral density in dB, one row of "bins" values per frame
+  std::vector<double> power_db;
+};
+
+/// Power spectral density of consecutive segments with a Hann window and 50% overlap.
+Spectrogram ComputeSpectrogram(const UniformSignal& signal, size_t segment_size);
+
+}  // namespace Spectral
@@ -0,0 +1,98 @@
+#include "spectrogram_plot.h"
+
+#include <QThread>
+#include "qwt_plot.h"
+#include "qwt_plot_spectrogram.h"
+#include "qwt_matrix_raster_data.h"
+#include "qwt_color_map.h"
+
+SpectrogramPlotWidget::SpectrogramPlotWidget(QWidget* parent) : PlotWidgetBase(parent)
+{
+}
+
+SpectrogramPlotWidget::~SpectrogramPlotWidget()
+{
+  removeSpectrogram();
+}
+
+void SpectrogramPlotWidget::setSpectrogram(const Spectral::Spectrogram& spectrogram)
+{
+  removeSpectrogram();
+  if (spectrogram.frames == 0 || spectrogram.bins == 0)
+  {
+    return;
+  }
+
+  // QwtMatrixRasterData wants one row per frequency and one column per frame
+  QVector<double> matrix(int(spectrogram.frames * spectrogram.bins));
+  double min_db = std::numeric_limits<double>::max();
+  double max_db = std::numeric_limits<double>::lowest();
+  for (size_t frame = 0; frame < spectrogram.frames; frame++)
+  {
+    for (size_t bin = 0; bin < spectrogram.bins; bin++)
+    {
+      const double value = spectrogram.power_db[frame * spectrogram.bins + bin];
+      matrix[int(bin * spectrogram.frames + frame)] = value;
+      min_db = std::min(min_db, value);
+      max_db = std::max(max_db, value);
+    }
+  }
+
+  // each cell is centered on its time and frequency
+  _time_range.min = spectrogram.t0 - 0.5 * spectrogram.time_step;
+  _time_range.max = _time_range.min + spectrogram.time_step * double(spectrogram.frames);
+  _frequency_range.min = -0.5 * spectrogram.frequency_step;
+  _frequency_range.max =
+      _frequency_range.min + spectrogram.frequency_step * double(spectrogram.bins);
+
+  auto raster = new QwtMatrixRasterData();
+  raster->setValueMatrix(matrix, int(spectrogram.frames));
+  raster->setInterval(Qt::XAxis, QwtInterval(_time_range.min, _time_range.max));
+  raster->setInterval(Qt::YAxis, QwtInterval(_frequency_range.min, _frequency_range.max));
+  raster->setInterval(Qt::ZAxis, QwtInterval(min_db, max_db));
+
+  auto color_map = new QwtLinearColorMap(QColor(0, 0, 64), QColor(255, 255, 160));
+  color_map->addColorStop(0.25, QColor(80, 0, 160));
+  color_map->addColorStop(0.5, QColor(220, 40, 80));
+  color_map->addColorStop(0.75, QColor(250, 160, 20));
+
+  _spectrogram = new QwtPlotSpectrogram();
+  _spectrogram->setRenderThreadCount(uint(std::max(1, QThread::idealThreadCount())));
+  _spectrogram->setColorMap(color_map);
+  _spectrogram->setData(raster);
+  _spectrogram->attach(qwtPlot());
+}
+
+PJ::Range SpectrogramPlotWidget::getVisualizationRangeX() const
+{
+  if (_spectrogram)
+  {
+    return _time_range;
+  }
+  return PlotWidgetBase::getVisualizationRangeX();
+}
+
+PJ::Range SpectrogramPlotWidget::getVisualizationRangeY(PJ::Range range_X) const
+{
+  if (_spectrogram)
+  {
+    return _frequency_range;
+  }
+  return PlotWidgetBase::getVisualizationRangeY(range_X);
+}
+
+void SpectrogramPlotWidget::removeAllCurves()
+{
+  removeSpectrogram();
+  PlotWidgetBase::removeAllCurves();
+}
+
+void SpectrogramPlotWidget::removeSpectrogram()
+{
+  if (_spectrogram)
+  {
+    _spectrogram->detach();
+    delete _spectrogram;
+    _spectrogram = nullptr;
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "PlotJuggler/plotwidget_base.h"
+#include "spectral_analysis.h"
+
+class QwtPlotSpectrogram;
+
+/**
+ * @brief PlotWidgetBase that can also show a spectrogram as a heatmap,
+ * with time on the X axis and frequency on the Y axis.
+ */
+class SpectrogramPlotWidget : public PJ::PlotWidgetBase
+{
+  Q_OBJECT
+
+public:
+  explicit SpectrogramPlotWidget(QWidget* parent);
+
+  ~SpectrogramPlotWidget() override;
+
+  /// Replace the current spectrogram, if any.
+  void setSpectrogram(const Spectral::Spectrogram& spectrogram);
+
+  bool hasSpectrogram() const
+  {
+    return _spectrogram != nullptr;
+  }
+
+  PJ::Range getVisualizationRangeX() const override;
+
+  PJ::Range getVisualizationRangeY(PJ::Range range_X) const override;
+
+public slots:
+
+  void removeAllCurves() override;
+
+private:
+  QwtPlotSpectrogram* _spectrogram = nullptr;
+  PJ::Range _time_range;
+  PJ::Range _frequency_range;
+
+  void removeSpectrogram();
+};
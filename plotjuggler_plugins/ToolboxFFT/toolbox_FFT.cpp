@@ -7,10 +7,10 @@
 #include <QDebug>
 #include <QDragEnterEvent>
 #include <QSettings>
+#include <QtConcurrent>
 
 #include "PlotJuggler/transform_function.h"
 #include "PlotJuggler/svg_util.h"
-#include "KissFFT/kiss_fftr.h"
 
 ToolboxFFT::ToolboxFFT()
 {
@@ -27,6 +27,10 @@ ToolboxFFT::ToolboxFFT()
   connect(ui->pushButtonSave, &QPushButton::clicked, this, &ToolboxFFT::onSaveCurve);
 
   connect(ui->pushButtonClear, &QPushButton::clicked, this, &ToolboxFFT::onClearCurves);
+
+  // the amplitude spectrum uses the entire signal, not segments
+  connect(ui->comboOutput, qOverload<int>(&QComboBox::currentIndexChanged), this,
+          [this](int index) { ui->comboWindowSize->setEnabled(index != AMPLITUDE); });
 }
 
 ToolboxFFT::~ToolboxFFT()
@@ -40,7 +44,7 @@ void ToolboxFFT::init(PJ::PlotDataMapRef& src_data, PJ::TransformsMap& transform
   _transforms = &transform_map;
 
   _plot_widget_A = new PJ::PlotWidgetBase(ui->framePlotPreviewA);
-  _plot_widget_B = new PJ::PlotWidgetBase(ui->framePlotPreviewB);
+  _plot_widget_B = new SpectrogramPlotWidget(ui->framePlotPreviewB);
 
   auto preview_layout_A = new QHBoxLayout(ui->framePlotPreviewA);
   preview_layout_A->setMargin(6);
@@ -78,18 +82,31 @@ void ToolboxFFT::calculateCurveFFT()
 {
   _plot_widget_B->removeAllCurves();
 
+  const auto output = static_cast<OutputType>(ui->comboOutput->currentIndex());
+  const size_t segment_size = ui->comboWindowSize->currentText().toUInt();
+
+  struct CurveInput
+  {
+    std::string curve_id;
+    QColor color;
+    Spectral::UniformSignal signal;
+    Spectral::Spectrum spectrum;
+  };
+  std::vector<CurveInput> inputs;
+
+  // PlotData is read only in this thread, the rest of the work can go in parallel
   for (const auto& curve_id : _curve_names)
   {
     auto it = _plot_data->numeric.find(curve_id);
     if (it == _plot_data->numeric.end())
     {
-      return;
+      continue;
     }
     PlotData& curve_data = it->second;
 
-    if( curve_data.size() == 0)
+    if (curve_data.size() == 0)
     {
-      return;
+      continue;
     }
 
     size_t min_index = 0;
@@ -101,77 +118,71 @@ void ToolboxFFT::calculateCurveFFT()
       max_index = curve_data.getIndexFromX(_zoom_range.max);
     }
 
-    size_t N = 1 + max_index - min_index;
-
-    if (N & 1)
-    {  // if not even, make it even
-      N--;
-      max_index--;
+    if (max_index < min_index + 7)
+    {
+      continue;
     }
 
-    if (N < 8)
+    CurveInput input;
+    input.curve_id = curve_id;
+    input.color = Qt::transparent;
+    auto colorHint = curve_data.attribute(COLOR_HINT);
+    if (colorHint.isValid())
     {
-      return;
+      input.color = colorHint.value<QColor>();
     }
-
-    double dT = (curve_data.at(max_index).x - curve_data.at(min_index).x) / double(N - 1);
-
-    std::vector<kiss_fft_scalar> input;
-    input.reserve(curve_data.size());
-
-    double sum = 0;
-    if(ui->checkAverage->isChecked())
+    input.signal = Spectral::Resample(curve_data, min_index, max_index);
+    if (ui->checkAverage->isChecked())
     {
-      for (size_t i = 0; i < N; i++)
-      {
-        sum += curve_data[i + min_index].y;
-      }
+      Spectral::RemoveAverage(input.signal);
     }
-    double average = sum / double(N);
+    inputs.push_back(std::move(input));
 
-    for (size_t i = 0; i < N; i++)
+    if (output == SPECTROGRAM)
     {
-      size_t index = i + min_index;
-      const auto& p = curve_data[index];
-      input.push_back(static_cast<kiss_fft_scalar>(p.y - average));
-
-      if (i != 0)
-      {
-        double dTi = (p.x - curve_data[index - 1].x);
-        double diff = dTi - dT;
-        // std_dev += diff*diff;
-      }
+      break;
     }
-    // std_dev = sqrt(std_dev / double(N-1) );
-
-    std::vector<kiss_fft_cpx> out(N / 2 + 1);
-
-    auto config = kiss_fftr_alloc(N, false, nullptr, nullptr);
+  }
 
-    QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-    kiss_fftr(config, input.data(), out.data());
-    QApplication::restoreOverrideCursor();
+  QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-    auto& curver_fft = _local_data.getOrCreateScatterXY(curve_id);
-    curver_fft.clear();
-    for (size_t i = 0; i < N / 2; i++)
+  if (output == SPECTROGRAM)
+  {
+    if (!inputs.empty())
     {
-      kiss_fft_scalar Hz = i * (1.0 / dT) / double(N);
-      kiss_fft_scalar amplitude = std::hypot(out[i].r, out[i].i) / N;
-      curver_fft.pushBack({ Hz, amplitude });
+      _plot_widget_B->setSpectrogram(
+          Spectral::ComputeSpectrogram(inputs.front().signal, segment_size));
     }
-
-    QColor color = Qt::transparent;
-    auto colorHint = curve_data.attribute(COLOR_HINT);
-    if (colorHint.isValid())
+  }
+  else
+  {
+    // one task per curve, in the global thread pool. Each of them borrows its own
+    // plan from the FFTPlanCache
+    QtConcurrent::blockingMap(inputs, [output, segment_size](CurveInput& input) {
+      input.spectrum = (output == POWER_SPECTRAL_DENSITY) ?
+                           Spectral::WelchPSD(input.signal, segment_size) :
+                           Spectral::AmplitudeSpectrum(input.signal);
+    });
+
+    for (const auto& input : inputs)
     {
-      color = colorHint.value<QColor>();
+      const auto& spectrum = input.spectrum;
+      const auto& curve_id = input.curve_id;
+
+      auto& curver_fft = _local_data.getOrCreateScatterXY(curve_id);
+      curver_fft.clear();
+      for (size_t j = 0; j < spectrum.value.size(); j++)
+      {
+        curver_fft.pushBack({ spectrum.frequency[j], spectrum.value[j] });
+      }
+      _plot_widget_B->addCurve(curve_id + "_FFT", curver_fft, input.color);
     }
+  }
 
-    _plot_widget_B->addCurve(curve_id + "_FFT", curver_fft, color);
+  QApplication::restoreOverrideCursor();
 
-    free(config);
-  }
+  // a spectrogram can't be saved as a curve
+  ui->pushButtonSave->setEnabled(output != SPECTROGRAM);
 
   _plot_widget_B->resetZoom();
 }
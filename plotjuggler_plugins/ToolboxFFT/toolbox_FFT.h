@@ -4,6 +4,7 @@
 #include <thread>
 #include "PlotJuggler/toolbox_base.h"
 #include "PlotJuggler/plotwidget_base.h"
+#include "spectrogram_plot.h"
 
 namespace Ui
 {
@@ -43,7 +44,7 @@ private:
   QStringList _dragging_curves;
 
   PJ::PlotWidgetBase* _plot_widget_A = nullptr;
-  PJ::PlotWidgetBase* _plot_widget_B = nullptr;
+  SpectrogramPlotWidget* _plot_widget_B = nullptr;
 
   PJ::PlotDataMapRef* _plot_data = nullptr;
   PJ::TransformsMap* _transforms = nullptr;
@@ -54,6 +55,14 @@ private:
 
   std::vector<std::string> _curve_names;
 
+  // same order of the items in comboOutput
+  enum OutputType
+  {
+    AMPLITUDE = 0,
+    POWER_SPECTRAL_DENSITY = 1,
+    SPECTROGRAM = 2
+  };
+
 private slots:
 
   void onDragEnterEvent(QDragEnterEvent* event);
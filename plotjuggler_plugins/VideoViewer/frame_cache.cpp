@@ -0,0 +1,132 @@
+#include "frame_cache.h"
+
+namespace
+{
+size_t ImageBytes(const QImage& image)
+{
+  return size_t(image.bytesPerLine()) * size_t(image.height());
+}
+}  // namespace
+
+FrameCache::FrameCache(DecoderFactory factory, int worker_count, size_t memory_budget,
+                       QObject* parent)
+  : QObject(parent), _memory_budget(memory_budget)
+{
+  for (int i = 0; i < std::max(1, worker_count); i++)
+  {
+    _workers.emplace_back(&FrameCache::workerLoop, this, factory);
+  }
+}
+
+FrameCache::~FrameCache()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+    _pending.clear();
+  }
+  _condition.notify_all();
+  for (auto& worker : _workers)
+  {
+    worker.join();
+  }
+}
+
+QImage FrameCache::request(int frame, int frame_count)
+{
+  QImage image;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _current_frame = frame;
+
+    auto it = _frames.find(frame);
+    if (it != _frames.end())
+    {
+      _lru.splice(_lru.begin(), _lru, it->second.lru_position);
+      image = it->second.image;
+    }
+
+    // the previous requests are not interesting anymore
+    _pending.clear();
+    auto schedule = [&](int index) {
+      if (index >= 0 && index < frame_count && _frames.count(index) == 0 &&
+          _in_progress.count(index) == 0)
+      {
+        _pending.push_back(index);
+      }
+    };
+    schedule(frame);
+    for (int i = 1; i <= PREFETCH_AHEAD; i++)
+    {
+      schedule(frame + i);
+      if (i <= PREFETCH_BEHIND)
+      {
+        schedule(frame - i);
+      }
+    }
+  }
+  _condition.notify_all();
+  return image;
+}
+
+size_t FrameCache::memoryUsage() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _memory_usage;
+}
+
+void FrameCache::workerLoop(DecoderFactory factory)
+{
+  auto decoder = factory();
+
+  while (true)
+  {
+    int frame = 0;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this]() { return _stop || !_pending.empty(); });
+      if (_stop)
+      {
+        return;
+      }
+      frame = _pending.front();
+      _pending.pop_front();
+      _in_progress.insert(frame);
+    }
+
+    QImage image = decoder ? decoder->decode(frame) : QImage();
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _in_progress.erase(frame);
+      if (image.isNull())
+      {
+        continue;
+      }
+      insert(frame, std::move(image));
+    }
+    // queued to the thread of the receivers
+    emit frameReady(frame);
+  }
+}
+
+void FrameCache::insert(int frame, QImage image)
+{
+  _memory_usage += ImageBytes(image);
+  _lru.push_front(frame);
+  _frames[frame] = { std::move(image), _lru.begin() };
+
+  // keep at least the frame just decoded
+  while (_memory_usage > _memory_budget && _lru.size() > 1)
+  {
+    if (_lru.back() == _current_frame)
+    {
+      _lru.splice(_lru.begin(), _lru, std::prev(_lru.end()));
+      continue;
+    }
+    auto it = _frames.find(_lru.back());
+    _memory_usage -= ImageBytes(it->second.image);
+    _frames.erase(it);
+    _lru.pop_back();
+  }
+}
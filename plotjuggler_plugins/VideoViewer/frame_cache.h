@@ -0,0 +1,95 @@
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <QObject>
+#include <QImage>
+
+/// Decodes single frames. Each worker of FrameCache owns its own instance.
+class FrameDecoder
+{
+public:
+  virtual ~FrameDecoder() = default;
+
+  /// Returns a null image if the frame can't be decoded.
+  virtual QImage decode(int frame) = 0;
+};
+
+/**
+ * @brief Decoded frames, kept within a memory budget.
+ *
+ * Frames are decoded by a pool of worker threads. Every request schedules the
+ * frame itself and its neighbours (more ahead than behind), dropping the
+ * requests that were scheduled before and not started yet, therefore the
+ * workers follow the position of the tracker. When the budget is exceeded, the
+ * least recently used frames are discarded.
+ */
+class FrameCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  using DecoderFactory = std::function<std::unique_ptr<FrameDecoder>()>;
+
+  // frames decoded in advance, after and before the requested one
+  static constexpr int PREFETCH_AHEAD = 30;
+  static constexpr int PREFETCH_BEHIND = 10;
+
+  /// The factory is invoked by each worker, in its own thread.
+  FrameCache(DecoderFactory factory, int worker_count, size_t memory_budget,
+             QObject* parent = nullptr);
+
+  ~FrameCache() override;
+
+  /**
+   * @brief Returns the frame if it is cached, a null image otherwise.
+   * In both cases, the frames around it are scheduled for decoding.
+   * frameReady() is emitted when a frame becomes available.
+   */
+  QImage request(int frame, int frame_count);
+
+  size_t memoryUsage() const;
+
+signals:
+
+  void frameReady(int frame);
+
+private:
+  struct Entry
+  {
+    QImage image;
+    std::list<int>::iterator lru_position;
+  };
+
+  mutable std::mutex _mutex;
+  std::condition_variable _condition;
+  bool _stop = false;
+
+  std::unordered_map<int, Entry> _frames;
+  // most recently used at the front
+  std::list<int> _lru;
+  size_t _memory_usage = 0;
+  size_t _memory_budget;
+  // last requested frame, never evicted
+  int _current_frame = -1;
+
+  std::deque<int> _pending;
+  std::set<int> _in_progress;
+
+  std::vector<std::thread> _workers;
+
+  void workerLoop(DecoderFactory factory);
+
+  void insert(int frame, QImage image);
+};
+
+#endif  // FRAME_CACHE_H
@@ -9,15 +9,70 @@
 #include <QMimeData>
 #include <QSettings>
 #include <cmath>
+#include <algorithm>
 #include <QPixmap>
 #include <QImage>
-#include <QProgressDialog>
+#include <QtAV/VideoFrameExtractor.h>
 
 #include "PlotJuggler/svg_util.h"
 
 #define QOI_IMPLEMENTATION
 #include "qoi.h"
 
+namespace
+{
+// memory used by the decoded frames
+constexpr size_t FRAME_CACHE_BUDGET = 512 * 1024 * 1024;
+constexpr int FRAME_CACHE_WORKERS = 2;
+
+// Random access to the frames of a seekable video
+class ExtractorDecoder : public FrameDecoder
+{
+public:
+  ExtractorDecoder(const QString& filename, double fps) : _fps(fps)
+  {
+    _extractor.setAsync(false);
+    _extractor.setAutoExtract(false);
+    // accept a frame within half a period from the requested time
+    _extractor.setPrecision(std::max(1, static_cast<int>(500.0 / fps)));
+    _extractor.setSource(filename);
+    QObject::connect(&_extractor, &QtAV::VideoFrameExtractor::frameExtracted,
+                     [this](const QtAV::VideoFrame& frame) {
+                       _image = frame.toImage(QImage::Format_RGB888);
+                     });
+  }
+
+  QImage decode(int frame) override
+  {
+    _image = QImage();
+    _extractor.setPosition(static_cast<qint64>(double(frame) * 1000.0 / _fps));
+    _extractor.extract();
+    return _image;
+  }
+
+private:
+  double _fps;
+  QtAV::VideoFrameExtractor _extractor;
+  QImage _image;
+};
+
+class FunctionDecoder : public FrameDecoder
+{
+public:
+  FunctionDecoder(std::function<QImage(int)> function) : _function(std::move(function))
+  {
+  }
+
+  QImage decode(int frame) override
+  {
+    return _function(frame);
+  }
+
+private:
+  std::function<QImage(int)> _function;
+};
+}  // namespace
+
 ImageLabel::ImageLabel(QWidget *parent) :
   QWidget(parent)
 {
@@ -88,13 +143,36 @@ VideoDialog::VideoDialog(QWidget *parent) :
   _label = new ImageLabel(this);
   ui->verticalLayoutMain->addWidget(_label, 1.0);
   _label->setHidden(true);
+
+  connect(this, &VideoDialog::decodeProgress, this, &VideoDialog::onDecodeProgress);
 }
 
 VideoDialog::~VideoDialog()
 {
+  resetFrames();
   delete ui;
 }
 
+void VideoDialog::stopDecoding()
+{
+  _stop_decoding = true;
+  if (_decode_thread.joinable())
+  {
+    _decode_thread.join();
+  }
+}
+
+void VideoDialog::resetFrames()
+{
+  stopDecoding();
+  // the workers of the cache may be reading the compressed frames
+  _frame_cache.reset();
+  _compressed_frames.reset();
+  _frame_count = 0;
+  _current_frame = -1;
+  _decoded = false;
+}
+
 bool VideoDialog::loadFile(QString filename)
 {
   if(!filename.isEmpty() && QFileInfo::exists(filename))
@@ -103,13 +181,10 @@ bool VideoDialog::loadFile(QString filename)
     _media_player->pause(true);
     ui->lineFilename->setText(filename);
 
-    _frame_reader = std::make_unique<QtAV::FrameReader>();
-    _frame_reader->setMedia(filename);
-    _compressed_frames.clear();
+    resetFrames();
+    _filename = filename;
     ui->decodeButton->setEnabled(true);
 
-    _decoded = false;
-
     _video_output->widget()->setHidden(false);
     _label->setHidden(true);
     return true;
@@ -180,6 +255,24 @@ void VideoDialog::updateSlider()
       on_decodeButton_clicked();
     }
   }
+  else if (fps > 0 && !_frame_cache)
+  {
+    // frames are decoded in background, around the position of the slider
+    _frame_count = num_frames + 1;
+    const QString filename = _filename;
+    const double frame_rate = fps;
+    _frame_cache = std::make_unique<FrameCache>(
+        [filename, frame_rate]() {
+          return std::make_unique<ExtractorDecoder>(filename, frame_rate);
+        },
+        FRAME_CACHE_WORKERS, FRAME_CACHE_BUDGET);
+    connect(_frame_cache.get(), &FrameCache::frameReady, this,
+            &VideoDialog::onFrameReady);
+
+    _video_output->widget()->hide();
+    _label->setHidden(false);
+    on_timeSlider_valueChanged(ui->timeSlider->value());
+  }
 }
 
 void VideoDialog::on_timeSlider_valueChanged(int num)
@@ -188,20 +281,16 @@ void VideoDialog::on_timeSlider_valueChanged(int num)
   double period = 1000 / fps;
   qint64 frame_pos = static_cast<qint64>(qreal(num) * period );
 
-  if( _decoded )
+  if( _frame_cache )
   {
-    num = std::max(0, num);
-    num = std::min(int(_compressed_frames.size()-1), num);
-
-    auto& frame = _compressed_frames[num];
-    void* data = qoi_decode( frame.data, frame.length, &frame.info, 3);
-    QImage image(static_cast<uchar*>(data), frame.info.width, frame.info.height, QImage::Format_RGB888);
-
-    //qDebug() << "ratio: " << double(3*frame.info.width*frame.info.height) / double(frame.length);
-
-    _label->setPixmap( QPixmap::fromImage( image ) );
-    _label->repaint();
-    free(data);
+    if( _frame_count == 0 )
+    {
+      return;
+    }
+    _current_frame = std::clamp(num, 0, _frame_count - 1);
+    QImage image = _frame_cache->request(_current_frame, _frame_count);
+    // if not cached yet, it will be shown by onFrameReady()
+    showImage(image);
   }
   else
   {
@@ -210,6 +299,24 @@ void VideoDialog::on_timeSlider_valueChanged(int num)
   }
 }
 
+void VideoDialog::onFrameReady(int frame)
+{
+  if( _frame_cache && frame == _current_frame )
+  {
+    showImage(_frame_cache->request(frame, _frame_count));
+  }
+}
+
+void VideoDialog::showImage(const QImage& image)
+{
+  if( image.isNull() )
+  {
+    return;
+  }
+  _label->setPixmap( QPixmap::fromImage( image ) );
+  _label->repaint();
+}
+
 void VideoDialog::seekByValue(double value)
 {
   if( ui->radioButtonFrame->isChecked() )
@@ -280,71 +387,118 @@ void VideoDialog::on_clearButton_clicked()
   ui->timeSlider->setEnabled(false);
   ui->timeSlider->setValue(0);
   ui->decodeButton->setEnabled(false);
+  ui->decodeButton->setText(tr("Decode as individual Images"));
 
-  _decoded = false;
+  resetFrames();
   _video_output->widget()->setHidden(false);
   _label->setHidden(true);
-  _compressed_frames.clear();
 }
 
 
 void VideoDialog::on_decodeButton_clicked()
 {
-  if( _decoded )
+  if( _decoded || _decode_thread.joinable() )
   {
     return;
   }
+  _frame_cache.reset();
 
-  double fps = _media_player->statistics().video.frame_rate;
-  QProgressDialog progress_dialog;
-  progress_dialog.setWindowTitle("PlotJuggler Video");
-  progress_dialog.setLabelText("Decoding file");
-  progress_dialog.setWindowModality(Qt::ApplicationModal);
-  progress_dialog.setRange(0, _media_player->duration() * fps / 1000);
-  progress_dialog.setAutoClose(true);
-  progress_dialog.setAutoReset(true);
-  progress_dialog.show();
-
-  int count = 0;
-  while (_frame_reader->readMore())
-  {
-    while (_frame_reader->hasEnoughVideoFrames())
+  auto store = std::make_shared<CompressedFrames>();
+  _compressed_frames = store;
+
+  auto decode_frame = [store](int index) -> QImage {
+    const void* data = nullptr;
+    int length = 0;
+    qoi_desc info;
     {
-      const QtAV::VideoFrame frame = _frame_reader->getVideoFrame();
-      if (!frame)
+      std::lock_guard<std::mutex> lock(store->mutex);
+      if( index < 0 || index >= static_cast<int>(store->frames.size()) )
       {
-        continue;
+        return {};
       }
+      // the vector may grow, but the compressed data is never moved
+      const auto& frame = store->frames[index];
+      data = frame.data;
+      length = frame.length;
+      info = frame.info;
+    }
+    void* pixels = qoi_decode( data, length, &info, 3);
+    if( !pixels )
+    {
+      return {};
+    }
+    return QImage(static_cast<uchar*>(pixels), info.width, info.height, 3 * info.width,
+                  QImage::Format_RGB888, [](void* ptr) { free(ptr); }, pixels);
+  };
+  _frame_cache = std::make_unique<FrameCache>(
+      [decode_frame]() { return std::make_unique<FunctionDecoder>(decode_frame); },
+      FRAME_CACHE_WORKERS, FRAME_CACHE_BUDGET);
+  connect(_frame_cache.get(), &FrameCache::frameReady, this, &VideoDialog::onFrameReady);
 
-      QImage image = frame.toImage(QImage::Format_RGB888);
-
-      CompressedFrame compressed_frame;
-      compressed_frame.info.width = frame.width();
-      compressed_frame.info.height = frame.height();
-      compressed_frame.info.channels = 3;
-      compressed_frame.info.colorspace = QOI_LINEAR;
-      compressed_frame.data = qoi_encode(image.bits(), &compressed_frame.info, &compressed_frame.length);
+  _video_output->widget()->hide();
+  _label->setHidden(false);
+  ui->decodeButton->setEnabled(false);
 
-//      _frames.push_back( std::move(image) );
-      _compressed_frames.push_back( std::move(compressed_frame) );
+  // Decode in background: the frames can be watched while the rest of the video
+  // is still being decoded.
+  _stop_decoding = false;
+  const QString filename = _filename;
+  _decode_thread = std::thread([this, store, filename]() {
+    QtAV::FrameReader frame_reader;
+    frame_reader.setMedia(filename);
 
-      if( ++count % 10 == 0 )
+    int count = 0;
+    while (!_stop_decoding && frame_reader.readMore())
+    {
+      while (!_stop_decoding && frame_reader.hasEnoughVideoFrames())
       {
-        progress_dialog.setValue(count);
-        QApplication::processEvents();
-        if (progress_dialog.wasCanceled())
+        const QtAV::VideoFrame frame = frame_reader.getVideoFrame();
+        if (!frame)
         {
-          _compressed_frames.clear();
-          return;
+          continue;
+        }
+
+        QImage image = frame.toImage(QImage::Format_RGB888);
+
+        CompressedFrame compressed_frame;
+        compressed_frame.info.width = frame.width();
+        compressed_frame.info.height = frame.height();
+        compressed_frame.info.channels = 3;
+        compressed_frame.info.colorspace = QOI_LINEAR;
+        compressed_frame.data = qoi_encode(image.bits(), &compressed_frame.info, &compressed_frame.length);
+        {
+          std::lock_guard<std::mutex> lock(store->mutex);
+          store->frames.push_back( std::move(compressed_frame) );
+        }
+
+        if( ++count % 10 == 0 )
+        {
+          emit decodeProgress(count, false);
         }
       }
     }
-  }
-  _decoded = true;
-  _video_output->widget()->hide();
-  _label->setHidden(false);
+    emit decodeProgress(count, !_stop_decoding);
+  });
+}
 
-  ui->decodeButton->setEnabled(false);
-  ui->timeSlider->setRange(0, _compressed_frames.size()-1);
+void VideoDialog::onDecodeProgress(int frame_count, bool finished)
+{
+  if( _stop_decoding || !_compressed_frames )
+  {
+    return;  // canceled
+  }
+  if( finished )
+  {
+    _decode_thread.join();
+    _decoded = true;
+    ui->decodeButton->setText(tr("Decode as individual Images"));
+  }
+  else
+  {
+    ui->decodeButton->setText(tr("Decoding... %1 frames").arg(frame_count));
+  }
+  _frame_count = frame_count;
+  ui->timeSlider->setEnabled(frame_count > 0);
+  ui->timeSlider->setRange(0, std::max(0, frame_count - 1));
   on_timeSlider_valueChanged( ui->timeSlider->value() );
 }
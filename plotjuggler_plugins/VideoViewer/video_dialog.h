@@ -2,6 +2,9 @@
 #define VIDEO_DIALOG_H
 
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <QDialog>
 #include <QtAV>
 #include <QSlider>
@@ -11,6 +14,7 @@
 #include "ui_video_dialog.h"
 
 #include "qoi.h"
+#include "frame_cache.h"
 
 class ImageLabel : public QWidget
 {
@@ -37,7 +41,7 @@ class VideoDialog : public QDialog
 
 public:
   explicit VideoDialog(QWidget *parent = nullptr);
-  ~VideoDialog();
+  ~VideoDialog() override;
 
   QString referenceCurve() const;
 
@@ -72,15 +76,22 @@ private Q_SLOTS:
 
   void on_decodeButton_clicked();
 
+  void onFrameReady(int frame);
+
+  void onDecodeProgress(int frame_count, bool finished);
+
 signals:
 
   void closed();
 
+  // emitted by the decoding thread
+  void decodeProgress(int frame_count, bool finished);
+
 private:
   QtAV::VideoOutput *_video_output;
   QtAV::AVPlayer *_media_player;
-  std::unique_ptr<QtAV::FrameReader> _frame_reader;
-  //std::vector<QImage> _frames;
+  QString _filename;
+
   struct CompressedFrame
   {
     CompressedFrame(): length(0), data(nullptr) {}
@@ -100,7 +111,28 @@ private:
     qoi_desc info;
     void* data;
   };
-  std::vector<CompressedFrame> _compressed_frames;
+
+  // Filled by the decoding thread, read by the workers of _frame_cache.
+  // Frames are only appended, and their data is never moved.
+  struct CompressedFrames
+  {
+    std::mutex mutex;
+    std::vector<CompressedFrame> frames;
+  };
+  std::shared_ptr<CompressedFrames> _compressed_frames;
+
+  std::thread _decode_thread;
+  std::atomic_bool _stop_decoding{ false };
+
+  std::unique_ptr<FrameCache> _frame_cache;
+  int _frame_count = 0;
+  int _current_frame = -1;
+
+  void stopDecoding();
+
+  void resetFrames();
+
+  void showImage(const QImage& image);
 
   bool eventFilter(QObject* obj, QEvent* ev);
   QString _dragging_curve;
@@ -36,7 +36,7 @@ void PublisherVideo::updateState(double current_time)
     return;
   }
   const auto& data = it->second;
-  auto position = data.getYfromX(current_time);
+  auto position = data.getYfromX(current_time, _index_hint);
   if( position )
   {
     if( !_dialog->isPaused() )
@@ -47,6 +47,8 @@ private:
   bool _xml_loaded = false;
 
   VideoDialog* _dialog = nullptr;
+
+  int _index_hint = -1;
 };
 
 #endif  // STATE_PUBLISHER_VIDEO_VIEWER_H